@@ -0,0 +1,117 @@
+#include "AllocTracker.h"
+#ifndef ARDUINO
+#include <new>
+#include <stdlib.h>
+#endif
+
+#ifdef ALLOC_TRACKING
+
+static volatile uint32_t allocCount = 0;
+static volatile uint32_t allocBytes = 0;
+
+extern "C" {
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+  allocCount++;
+  allocBytes += size;
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+  allocCount++;
+  allocBytes += count * size;
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+  allocCount++;
+  allocBytes += size;
+  return __real_realloc(ptr, size);
+}
+
+}
+
+AllocStats allocSnapshot()
+{
+  return {allocCount, allocBytes};
+}
+
+#ifndef ARDUINO
+// Host builds: libstdc++'s operator new calls malloc inside the shared
+// library, where --wrap does not reach, so route it through the wrapped
+// malloc here.
+void* operator new(size_t size)
+{
+  void* ptr = malloc(size);
+  if (!ptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+  free(ptr);
+}
+#endif
+
+AllocScope::AllocScope(const char* name)
+  : name(name), start(allocSnapshot()), startMaxFreeBlock(ESP.getMaxFreeBlockSize())
+{
+}
+
+AllocScope::~AllocScope()
+{
+  AllocStats end = allocSnapshot();
+  uint32_t count = end.count - start.count;
+  if (count == 0) {
+    return;
+  }
+
+  int32_t blockDelta = (int32_t)ESP.getMaxFreeBlockSize() - (int32_t)startMaxFreeBlock;
+  Serial.printf("[HEAP] %s: %u allocs, %u bytes, max free block %+d\n",
+                name, count, end.bytes - start.bytes, blockDelta);
+}
+
+#else
+
+AllocStats allocSnapshot()
+{
+  return {0, 0};
+}
+
+AllocScope::AllocScope(const char* name)
+  : name(name), start{0, 0}, startMaxFreeBlock(0)
+{
+}
+
+AllocScope::~AllocScope()
+{
+}
+
+#endif
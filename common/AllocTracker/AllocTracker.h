@@ -0,0 +1,35 @@
+#pragma once
+#include <Arduino.h>
+
+// Debug-build heap accounting. Build with -DALLOC_TRACKING and link with
+// -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc so every heap allocation
+// (String, new, library code) goes through the counters below.
+// TRACK_ALLOCATIONS(name) opens a scope that prints allocation count, bytes
+// and the change in the largest free block whenever the scope allocated.
+// Without ALLOC_TRACKING the macro expands to nothing.
+
+struct AllocStats
+{
+  uint32_t count;
+  uint32_t bytes;
+};
+
+AllocStats allocSnapshot();
+
+class AllocScope
+{
+public:
+  explicit AllocScope(const char* name);
+  ~AllocScope();
+
+private:
+  const char* name;
+  AllocStats start;
+  uint32_t startMaxFreeBlock;
+};
+
+#ifdef ALLOC_TRACKING
+#define TRACK_ALLOCATIONS(name) AllocScope allocScope_(name)
+#else
+#define TRACK_ALLOCATIONS(name)
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+#include <Arduino.h>
+#include "FastGpio.h"
+
+// Pin maps for every firmware in this repo. Each project picks its board
+// with `using Board = ...;` so pin numbers stay compile-time constants.
+
+struct Lab1Board
+{
+  static constexpr uint8_t LED1 = D6;
+  static constexpr uint8_t LED2 = D4;
+  static constexpr uint8_t LED3 = D7;
+  static constexpr uint8_t BUTTON_PIN = D3;
+
+  using Leds = OutputGroup<LED1, LED2, LED3>;
+  using Button = DebouncedButton<BUTTON_PIN, 200>;
+};
+
+struct Lab2Device1Board
+{
+  static constexpr uint8_t GREEN_LED = D5;
+  static constexpr uint8_t RED_LED = D1;
+  static constexpr uint8_t BLUE_LED = D2;
+  static constexpr uint8_t BUTTON_PIN = D3;
+  static constexpr uint8_t SERIAL_RX = D7;
+  static constexpr uint8_t SERIAL_TX = D6;
+
+  using Leds = OutputGroup<GREEN_LED, RED_LED, BLUE_LED>;
+  using Button = DebouncedButton<BUTTON_PIN, 200>;
+};
+
+struct Lab2Device2Board
+{
+  static constexpr uint8_t LED1 = D5;
+  static constexpr uint8_t LED2 = D2;
+  static constexpr uint8_t LED3 = D1;
+  static constexpr uint8_t BUTTON_PIN = D3;
+  static constexpr uint8_t SERIAL_RX = D7;
+  static constexpr uint8_t SERIAL_TX = D6;
+
+  using Leds = OutputGroup<LED1, LED2, LED3>;
+  using Button = DebouncedButton<BUTTON_PIN, 200>;
+};
+
+struct ColorLoggerBoard
+{
+  static constexpr uint8_t I2C_SDA = D6;
+  static constexpr uint8_t I2C_SCL = D5;
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include <Arduino.h>
+
+// Compile-time GPIO helpers for GPIO0..GPIO15 on the ESP8266.
+// Pin numbers are template arguments, so masks fold into constants and a
+// whole group of outputs is updated with one write to GPOS (set) and one
+// to GPOC (clear) instead of a digitalWrite() per pin.
+
+template <uint8_t... Pins>
+struct PinMask;
+
+template <>
+struct PinMask<>
+{
+  static constexpr uint32_t value = 0;
+};
+
+template <uint8_t Pin, uint8_t... Rest>
+struct PinMask<Pin, Rest...>
+{
+  static_assert(Pin < 16, "GPOS/GPOC only cover GPIO0..GPIO15");
+  static constexpr uint32_t value = (1UL << Pin) | PinMask<Rest...>::value;
+};
+
+template <uint8_t... Pins>
+class OutputGroup
+{
+public:
+  static constexpr uint32_t mask = PinMask<Pins...>::value;
+  static constexpr uint8_t count = sizeof...(Pins);
+
+  static void begin()
+  {
+    int unused[] = {(pinMode(Pins, OUTPUT), 0)...};
+    (void)unused;
+    GPOC = mask;
+  }
+
+  // Drives every pin in the group: bits set in `bits` go HIGH, the rest LOW.
+  static inline void write(uint32_t bits)
+  {
+    GPOS = bits & mask;
+    GPOC = ~bits & mask;
+  }
+
+  // Drives the index-th pin of the group HIGH and all the others LOW.
+  static inline void only(uint8_t index)
+  {
+    write(bit(index));
+  }
+
+  static inline void allOff()
+  {
+    GPOC = mask;
+  }
+
+  static inline bool isOn(uint8_t index)
+  {
+    return GPO & bit(index);
+  }
+
+  static inline uint32_t bit(uint8_t index)
+  {
+    static const uint32_t bits[] = {(1UL << Pins)...};
+    return index < count ? bits[index] : 0;
+  }
+};
+
+template <uint8_t Pin>
+class InputPin
+{
+public:
+  static_assert(Pin < 16, "GPI only covers GPIO0..GPIO15");
+
+  static void begin(uint8_t mode)
+  {
+    pinMode(Pin, mode);
+  }
+
+  static inline bool read()
+  {
+    return GPI & (1UL << Pin);
+  }
+};
+
+// Active-low push button with a compile-time debounce window. accept() is
+// safe to call from an ISR: it only compares timestamps and reads GPI.
+template <uint8_t Pin, uint32_t DebounceMs>
+class DebouncedButton
+{
+public:
+  using Input = InputPin<Pin>;
+
+  static void begin()
+  {
+    Input::begin(INPUT_PULLUP);
+  }
+
+  static inline bool isPressed()
+  {
+    return !Input::read();
+  }
+
+  static inline __attribute__((always_inline)) bool accept(uint32_t now, volatile uint32_t& lastAccepted)
+  {
+    if (now - lastAccepted <= DebounceMs) {
+      return false;
+    }
+    lastAccepted = now;
+    return true;
+  }
+};
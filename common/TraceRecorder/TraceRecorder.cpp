@@ -0,0 +1,222 @@
+#include "TraceRecorder.h"
+#include <stdarg.h>
+
+#ifdef TRACE_RECORDING
+
+#define TRACE_QUEUE_SIZE 64
+#define TRACE_BUCKETS 16
+#define TRACE_STATS_INTERVAL 1000
+#define TRACE_OUTPUT_SIZE 2048
+#define TRACE_LINE_SIZE 256
+#define TRACE_UART_FIFO 128
+
+struct QueuedEvent
+{
+  uint32_t at;
+  TraceKind kind;
+  uint32_t a;
+  uint32_t b;
+};
+
+static QueuedEvent queue[TRACE_QUEUE_SIZE];
+static volatile uint8_t queueHead = 0;
+static volatile uint8_t queueTail = 0;
+static volatile uint32_t dropped = 0;
+
+// Formatted lines waiting for the serial port.
+static char output[TRACE_OUTPUT_SIZE];
+static uint16_t outputHead = 0;
+static uint16_t outputTail = 0;
+static uint32_t droppedLines = 0;
+
+static uint32_t loopBuckets[TRACE_BUCKETS];
+static uint32_t loopCount = 0;
+static uint32_t lastLoopUs = 0;
+static uint32_t lastStats = 0;
+static uint32_t minFreeHeap = UINT32_MAX;
+
+void IRAM_ATTR traceEvent(TraceKind kind, uint32_t a, uint32_t b)
+{
+  uint32_t state = xt_rsil(15);
+  uint8_t next = (queueHead + 1) % TRACE_QUEUE_SIZE;
+  if (next == queueTail) {
+    dropped++;
+  } else {
+    queue[queueHead] = {millis(), kind, a, b};
+    queueHead = next;
+  }
+  xt_wsr_ps(state);
+}
+
+static uint16_t outputFree()
+{
+  return (outputTail + TRACE_OUTPUT_SIZE - outputHead - 1) % TRACE_OUTPUT_SIZE;
+}
+
+// Queues a complete line for the serial port, or drops it if it does not
+// fit, so a reader never sees half a record.
+static bool queueLine(const char* line, size_t length)
+{
+  if (length > outputFree()) {
+    droppedLines++;
+    return false;
+  }
+  for (size_t i = 0; i < length; i++) {
+    output[outputHead] = line[i];
+    outputHead = (outputHead + 1) % TRACE_OUTPUT_SIZE;
+  }
+  return true;
+}
+
+// Writes whole queued lines to the UART without blocking. The firmware
+// still prints to Serial directly, so a line left half-written would let
+// those prints land inside a record. A line longer than the UART FIFO never
+// fits; it goes out in one write once the FIFO has drained.
+static void drainOutput()
+{
+  size_t room = Serial.availableForWrite();
+  size_t length = 0;
+  size_t ready = 0;
+  for (uint16_t i = outputTail; i != outputHead; i = (i + 1) % TRACE_OUTPUT_SIZE) {
+    length++;
+    if (length > room && (ready > 0 || room < TRACE_UART_FIFO)) break;
+    if (output[i] == '\n') {
+      ready = length;
+      if (length > room) break;
+    }
+  }
+
+  while (ready > 0) {
+    size_t run = TRACE_OUTPUT_SIZE - outputTail;
+    if (run > ready) run = ready;
+    Serial.write((const uint8_t*)output + outputTail, run);
+    outputTail = (outputTail + run) % TRACE_OUTPUT_SIZE;
+    ready -= run;
+  }
+}
+
+static size_t append(char* line, size_t used, const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  int written = vsnprintf(line + used, TRACE_LINE_SIZE - used, format, args);
+  va_end(args);
+  used += written > 0 ? written : 0;
+  return used < TRACE_LINE_SIZE ? used : TRACE_LINE_SIZE - 1;
+}
+
+// Percent-encodes '%', ',' and control characters so text fields can be
+// split on commas. Truncates rather than overrunning the line, keeping room
+// for the fields that follow.
+static size_t appendEncoded(char* line, size_t used, const char* text)
+{
+  static const char hex[] = "0123456789ABCDEF";
+  for (; *text && used + 16 < TRACE_LINE_SIZE; text++) {
+    uint8_t c = *text;
+    if (c == '%' || c == ',' || c < 0x20 || c == 0x7F) {
+      line[used++] = '%';
+      line[used++] = hex[c >> 4];
+      line[used++] = hex[c & 0x0F];
+    } else {
+      line[used++] = c;
+    }
+  }
+  line[used] = '\0';
+  return used;
+}
+
+void traceRequest(uint8_t method, const char* uri, uint32_t durationUs,
+                  const char* ifNoneMatch, const char* ifModifiedSince)
+{
+  char line[TRACE_LINE_SIZE];
+  size_t used = append(line, 0, "@H,%lu,%u,", (unsigned long)millis(), method);
+  used = appendEncoded(line, used, uri);
+  used = append(line, used, ",%lu,", (unsigned long)durationUs);
+  used = appendEncoded(line, used, ifNoneMatch);
+  used = append(line, used, ",");
+  used = appendEncoded(line, used, ifModifiedSince);
+  used = append(line, used, "\n");
+  queueLine(line, used);
+}
+
+// Moves events into the output buffer while there is room; the rest stay
+// queued for the next loop.
+static void flushQueue()
+{
+  char line[48];
+  while (queueTail != queueHead) {
+    QueuedEvent event = queue[queueTail];
+    int length = snprintf(line, sizeof(line), "@E,%lu,%c,%lu,%lu\n", (unsigned long)event.at, (char)event.kind,
+                          (unsigned long)event.a, (unsigned long)event.b);
+    if (length < 0 || (size_t)length > outputFree()) {
+      break;
+    }
+    queueLine(line, length);
+    queueTail = (queueTail + 1) % TRACE_QUEUE_SIZE;
+  }
+}
+
+static void flushStats(uint32_t now)
+{
+  char line[TRACE_LINE_SIZE];
+  size_t used = append(line, 0, "@L,%lu,%lu", (unsigned long)now, (unsigned long)loopCount);
+  for (uint8_t i = 0; i < TRACE_BUCKETS; i++) {
+    used = append(line, used, ",%lu", (unsigned long)loopBuckets[i]);
+    loopBuckets[i] = 0;
+  }
+  used = append(line, used, "\n");
+  queueLine(line, used);
+  loopCount = 0;
+
+  used = append(line, 0, "@M,%lu,%lu,%lu,%lu,%lu\n", (unsigned long)now, (unsigned long)ESP.getFreeHeap(),
+                (unsigned long)minFreeHeap, (unsigned long)ESP.getMaxFreeBlockSize(),
+                (unsigned long)(dropped + droppedLines));
+  queueLine(line, used);
+}
+
+// Call first thing in loop(): measures the previous iteration, then queues
+// events and, once a second, the loop and heap statistics, and passes
+// queued output to the UART. The time spent here is left out of the next
+// measurement.
+void traceLoop()
+{
+  uint32_t nowUs = micros();
+  if (lastLoopUs != 0) {
+    uint32_t duration = nowUs - lastLoopUs;
+    uint8_t bucket = 0;
+    while (duration > 1 && bucket < TRACE_BUCKETS - 1) {
+      duration >>= 1;
+      bucket++;
+    }
+    loopBuckets[bucket]++;
+    loopCount++;
+  }
+
+  uint32_t freeHeap = ESP.getFreeHeap();
+  if (freeHeap < minFreeHeap) minFreeHeap = freeHeap;
+
+  flushQueue();
+  uint32_t now = millis();
+  if (now - lastStats >= TRACE_STATS_INTERVAL) {
+    lastStats = now;
+    flushStats(now);
+  }
+  drainOutput();
+  lastLoopUs = micros();
+}
+
+#else
+
+void traceEvent(TraceKind, uint32_t, uint32_t)
+{
+}
+
+void traceRequest(uint8_t, const char*, uint32_t, const char*, const char*)
+{
+}
+
+void traceLoop()
+{
+}
+
+#endif
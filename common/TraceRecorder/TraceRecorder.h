@@ -0,0 +1,83 @@
+#pragma once
+#include <Arduino.h>
+
+// Debug-build trace of everything that drives a firmware: sensor readings,
+// button interrupts, serial bytes, HTTP and WebSocket traffic, plus loop
+// latency and heap statistics. Build with -DTRACE_RECORDING; without it all
+// macros expand to nothing.
+//
+// Events are queued in a fixed ring buffer (safe to push from an ISR) and
+// turned into lines prefixed with '@' so they can be filtered out of the
+// normal serial log:
+//
+//   @E,<ms>,<kind>,<a>,<b>            queued event, see TraceKind
+//   @H,<ms>,<method>,<uri>,<us>,<ifNoneMatch>,<ifModifiedSince>
+//                                     HTTP request: HTTPMethod value, path
+//                                     with query, handler duration and the
+//                                     conditional headers (empty if absent);
+//                                     text fields are percent-encoded
+//   @L,<ms>,<loops>,<b0>,...,<b15>    loop-duration histogram, bucket i
+//                                     counts loops of [2^i, 2^(i+1)) us
+//   @M,<ms>,<freeHeap>,<minFreeHeap>,<maxFreeBlock>,<dropped>
+//
+// Nothing is printed where it is recorded. Lines go into a RAM buffer and
+// traceLoop() hands the serial port only as much as its TX FIFO takes
+// without blocking, so a slow baud rate shows up as dropped records (counted
+// in @M) instead of as longer loops or handlers. The *_trace envs also raise
+// the baud rate.
+//
+// tools/trace-replay reads these lines back.
+
+enum TraceKind : uint8_t
+{
+  TRACE_SENSOR = 'S',      // a = red << 16 | green, b = blue << 16 | clear
+  TRACE_BUTTON = 'B',      // button interrupt
+  TRACE_SERIAL_RX = 'R',   // a = byte received from the partner device
+  TRACE_SERIAL_TX = 'T',   // a = byte sent to the partner device
+  TRACE_WEBSOCKET = 'W'    // a = client, b = payload length
+};
+
+void traceEvent(TraceKind kind, uint32_t a, uint32_t b);
+void traceRequest(uint8_t method, const char* uri, uint32_t durationUs,
+                  const char* ifNoneMatch, const char* ifModifiedSince);
+void traceLoop();
+
+// Records the current request of an ESP8266WebServer-like server, with the
+// handler's duration, when the scope ends. The conditional headers are only
+// seen if the sketch passes them to collectHeaders().
+template <typename Server>
+class TraceRequestScope
+{
+public:
+  explicit TraceRequestScope(Server& server) : server(server), start(micros()) {}
+
+  ~TraceRequestScope()
+  {
+    uint32_t duration = micros() - start;
+    char uri[96];
+    size_t used = snprintf(uri, sizeof(uri), "%s", server.uri().c_str());
+    char separator = '?';
+    for (int i = 0; i < server.args() && used < sizeof(uri); i++) {
+      if (server.argName(i) == "plain") continue;
+      used += snprintf(uri + used, sizeof(uri) - used, "%c%s=%s", separator,
+                       server.argName(i).c_str(), server.arg(i).c_str());
+      separator = '&';
+    }
+    traceRequest((uint8_t)server.method(), uri, duration,
+                 server.header("If-None-Match").c_str(), server.header("If-Modified-Since").c_str());
+  }
+
+private:
+  Server& server;
+  uint32_t start;
+};
+
+#ifdef TRACE_RECORDING
+#define TRACE_EVENT(kind, a, b) traceEvent(kind, a, b)
+#define TRACE_REQUEST(server) TraceRequestScope<decltype(server)> traceRequestScope_(server)
+#define TRACE_LOOP() traceLoop()
+#else
+#define TRACE_EVENT(kind, a, b)
+#define TRACE_REQUEST(server)
+#define TRACE_LOOP()
+#endif
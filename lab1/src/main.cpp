@@ -1,11 +1,9 @@
 #include <Arduino.h>
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
+#include <BoardPins.h>
 
-#define LED1 D6
-#define LED2 D4
-#define LED3 D7
-#define BUTTON_PIN D3
+using Board = Lab1Board;
 
 const char* apSSID = "ESP8266_AP";
 const char* apPassword = "12345678";
@@ -36,9 +34,7 @@ void updateLEDs() {
 
         ledState = (ledState + 1) % 3;
 
-        digitalWrite(LED1, ledState == 0 ? HIGH : LOW);
-        digitalWrite(LED2, ledState == 1 ? HIGH : LOW);
-        digitalWrite(LED3, ledState == 2 ? HIGH : LOW);
+        Board::Leds::only(ledState);
 
         Serial.print("[LED] New State: ");
         Serial.println(ledState);
@@ -65,12 +61,10 @@ void processWebRequests() {
 }
 
 void setupHardware() {
-    pinMode(LED1, OUTPUT);
-    pinMode(LED2, OUTPUT);
-    pinMode(LED3, OUTPUT);
-    pinMode(BUTTON_PIN, INPUT_PULLUP);
+    Board::Leds::begin();
+    Board::Button::begin();
 
-    attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), handleButtonPress, FALLING);
+    attachInterrupt(digitalPinToInterrupt(Board::BUTTON_PIN), handleButtonPress, FALLING);
 
     Serial.begin(9600);
     Serial.println("[SYSTEM] Initializing hardware...");
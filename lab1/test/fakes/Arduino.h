@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Host stand-in for the parts of the ESP8266 Arduino core that FastGpio.h
+// and BoardPins.h use. GPOS/GPOC/GPO/GPI are a mock register file that
+// counts writes, so tests can check both pin levels and register traffic.
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x00
+#define INPUT_PULLUP 0x02
+#define OUTPUT 0x01
+
+static const uint8_t D0 = 16;
+static const uint8_t D1 = 5;
+static const uint8_t D2 = 4;
+static const uint8_t D3 = 0;
+static const uint8_t D4 = 2;
+static const uint8_t D5 = 14;
+static const uint8_t D6 = 12;
+static const uint8_t D7 = 13;
+static const uint8_t D8 = 15;
+
+struct FakeGpio
+{
+  uint32_t out = 0;
+  uint32_t in = 0xFFFF;
+  uint32_t writes = 0;
+  uint8_t modes[17] = {};
+};
+
+inline FakeGpio fakeGpio;
+
+struct FakeSetRegister
+{
+  void operator=(uint32_t bits)
+  {
+    fakeGpio.out |= bits;
+    fakeGpio.writes++;
+  }
+};
+
+struct FakeClearRegister
+{
+  void operator=(uint32_t bits)
+  {
+    fakeGpio.out &= ~bits;
+    fakeGpio.writes++;
+  }
+};
+
+inline FakeSetRegister fakeGpos;
+inline FakeClearRegister fakeGpoc;
+
+#define GPOS fakeGpos
+#define GPOC fakeGpoc
+#define GPO fakeGpio.out
+#define GPI fakeGpio.in
+
+inline void pinMode(uint8_t pin, uint8_t mode)
+{
+  fakeGpio.modes[pin] = mode;
+}
+
+// Like the core's __digitalWrite for GPIO0..15: one GPOS or GPOC write per
+// call.
+inline void digitalWrite(uint8_t pin, uint8_t value)
+{
+  if (value) {
+    GPOS = 1UL << pin;
+  } else {
+    GPOC = 1UL << pin;
+  }
+}
@@ -0,0 +1,112 @@
+#include <unity.h>
+#include <BoardPins.h>
+
+using Leds = Lab1Board::Leds;
+using Button = Lab1Board::Button;
+
+static_assert(Leds::mask == ((1UL << D6) | (1UL << D4) | (1UL << D7)), "mask folds at compile time");
+static_assert(PinMask<>::value == 0, "empty mask");
+
+static const uint32_t OTHER_PINS = (1UL << D1) | (1UL << D5);
+
+void setUp(void)
+{
+  fakeGpio = FakeGpio();
+}
+
+void tearDown(void)
+{
+}
+
+void test_begin_sets_outputs_and_clears_them(void)
+{
+  fakeGpio.out = Leds::mask | OTHER_PINS;
+  Leds::begin();
+  TEST_ASSERT_EQUAL(OUTPUT, fakeGpio.modes[D6]);
+  TEST_ASSERT_EQUAL(OUTPUT, fakeGpio.modes[D4]);
+  TEST_ASSERT_EQUAL(OUTPUT, fakeGpio.modes[D7]);
+  TEST_ASSERT_EQUAL_HEX32(OTHER_PINS, fakeGpio.out);
+}
+
+void test_only_drives_one_led_with_two_register_writes(void)
+{
+  fakeGpio.out = OTHER_PINS;
+  for (uint8_t state = 0; state < 3; state++) {
+    fakeGpio.writes = 0;
+    Leds::only(state);
+    TEST_ASSERT_EQUAL(2, fakeGpio.writes);
+    TEST_ASSERT_EQUAL_HEX32(OTHER_PINS | Leds::bit(state), fakeGpio.out);
+    for (uint8_t i = 0; i < 3; i++) {
+      TEST_ASSERT_EQUAL(i == state, Leds::isOn(i));
+    }
+  }
+}
+
+void test_write_ignores_bits_outside_the_group(void)
+{
+  Leds::write(0xFFFFFFFF);
+  TEST_ASSERT_EQUAL_HEX32(Leds::mask, fakeGpio.out);
+  Leds::write(0);
+  TEST_ASSERT_EQUAL_HEX32(0, fakeGpio.out);
+}
+
+void test_bit_out_of_range_is_zero(void)
+{
+  TEST_ASSERT_EQUAL_HEX32(1UL << D6, Leds::bit(0));
+  TEST_ASSERT_EQUAL_HEX32(1UL << D7, Leds::bit(2));
+  TEST_ASSERT_EQUAL_HEX32(0, Leds::bit(3));
+  fakeGpio.out = Leds::mask;
+  Leds::only(3);
+  TEST_ASSERT_EQUAL_HEX32(0, fakeGpio.out);
+}
+
+void test_all_off_is_one_write(void)
+{
+  fakeGpio.out = Leds::mask | OTHER_PINS;
+  Leds::allOff();
+  TEST_ASSERT_EQUAL(1, fakeGpio.writes);
+  TEST_ASSERT_EQUAL_HEX32(OTHER_PINS, fakeGpio.out);
+}
+
+void test_digital_write_update_takes_three_writes(void)
+{
+  uint8_t state = 1;
+  digitalWrite(Lab1Board::LED1, state == 0 ? HIGH : LOW);
+  digitalWrite(Lab1Board::LED2, state == 1 ? HIGH : LOW);
+  digitalWrite(Lab1Board::LED3, state == 2 ? HIGH : LOW);
+  TEST_ASSERT_EQUAL(3, fakeGpio.writes);
+  TEST_ASSERT_EQUAL_HEX32(Leds::bit(1), fakeGpio.out);
+}
+
+void test_button_reads_active_low_from_gpi(void)
+{
+  Button::begin();
+  TEST_ASSERT_EQUAL(INPUT_PULLUP, fakeGpio.modes[D3]);
+  TEST_ASSERT_FALSE(Button::isPressed());
+  fakeGpio.in &= ~(1UL << D3);
+  TEST_ASSERT_TRUE(Button::isPressed());
+}
+
+void test_button_debounce_window(void)
+{
+  volatile uint32_t lastAccepted = 0;
+  TEST_ASSERT_TRUE(Button::accept(1000, lastAccepted));
+  TEST_ASSERT_FALSE(Button::accept(1100, lastAccepted));
+  TEST_ASSERT_FALSE(Button::accept(1200, lastAccepted));
+  TEST_ASSERT_TRUE(Button::accept(1201, lastAccepted));
+  TEST_ASSERT_EQUAL(1201, lastAccepted);
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_begin_sets_outputs_and_clears_them);
+  RUN_TEST(test_only_drives_one_led_with_two_register_writes);
+  RUN_TEST(test_write_ignores_bits_outside_the_group);
+  RUN_TEST(test_bit_out_of_range_is_zero);
+  RUN_TEST(test_all_off_is_one_write);
+  RUN_TEST(test_digital_write_update_takes_three_writes);
+  RUN_TEST(test_button_reads_active_low_from_gpi);
+  RUN_TEST(test_button_debounce_window);
+  return UNITY_END();
+}
@@ -0,0 +1,68 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <BoardPins.h>
+
+// Runs on the board: `pio test -e wemos_d1_mini -f test_gpio_cycles`.
+// Compares CPU cycles per LED update for the old digitalWrite() sequence
+// and the OutputGroup write through GPOS/GPOC.
+
+using Board = Lab1Board;
+
+#define ROUNDS 3000
+
+static void __attribute__((noinline)) updateWithDigitalWrite(uint8_t ledState)
+{
+  digitalWrite(Board::LED1, ledState == 0 ? HIGH : LOW);
+  digitalWrite(Board::LED2, ledState == 1 ? HIGH : LOW);
+  digitalWrite(Board::LED3, ledState == 2 ? HIGH : LOW);
+}
+
+static void __attribute__((noinline)) updateWithOutputGroup(uint8_t ledState)
+{
+  Board::Leds::only(ledState);
+}
+
+static uint32_t cyclesPerUpdate(void (*update)(uint8_t))
+{
+  uint32_t start = ESP.getCycleCount();
+  for (uint16_t i = 0; i < ROUNDS; i++) {
+    update(i % 3);
+  }
+  return (ESP.getCycleCount() - start) / ROUNDS;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+  Board::Leds::allOff();
+}
+
+void test_output_group_needs_fewer_cycles_than_digital_write(void)
+{
+  Board::Leds::begin();
+  cyclesPerUpdate(updateWithDigitalWrite);
+
+  uint32_t digital = cyclesPerUpdate(updateWithDigitalWrite);
+  uint32_t group = cyclesPerUpdate(updateWithOutputGroup);
+
+  char report[96];
+  snprintf(report, sizeof(report), "cycles per LED update: digitalWrite %u, OutputGroup %u",
+           (unsigned)digital, (unsigned)group);
+  TEST_MESSAGE(report);
+  TEST_ASSERT_LESS_THAN(digital, group);
+}
+
+void setup()
+{
+  delay(2000);
+  UNITY_BEGIN();
+  RUN_TEST(test_output_group_needs_fewer_cycles_than_digital_write);
+  UNITY_END();
+}
+
+void loop()
+{
+}
@@ -5,17 +5,15 @@
 #include "CommunicationService.h"
 #include "ToogleCommand.h"
 #include <WebSocketsServer.h> 
+#include <BoardPins.h>
 
-#define GREEN_LED D5
-#define RED_LED D1
-#define BLUE_LED D2
-#define BUTTON_PIN D3
+using Board = Lab2Device1Board;
 
 const char* ssid = "ESP8266_AP";
 const char* pass = "12345678";
 
 ESP8266WebServer server(80);
-SoftwareSerial mySerial(D7, D6, false);
+SoftwareSerial mySerial(Board::SERIAL_RX, Board::SERIAL_TX, false);
 CommunicationService communicationService(mySerial, 115200); 
 WebSocketsServer webSocket(81);
 
@@ -71,9 +69,7 @@ void updateLEDs() {
     if (currentMillis - previousMillis >= interval) {
         previousMillis = currentMillis;
         ledState = (ledState + 1) % 3;
-        digitalWrite(GREEN_LED, ledState == 0 ? HIGH : LOW);
-        digitalWrite(RED_LED, ledState == 1 ? HIGH : LOW);
-        digitalWrite(BLUE_LED, ledState == 2 ? HIGH : LOW);
+        Board::Leds::only(ledState);
         
         Serial.print("[LED] New State: ");
         Serial.println(ledState);
@@ -102,11 +98,9 @@ void processWebRequests() {
 }
 
 void setupHardware() {
-    pinMode(GREEN_LED, OUTPUT);
-    pinMode(RED_LED, OUTPUT);
-    pinMode(BLUE_LED, OUTPUT);
-    pinMode(BUTTON_PIN, INPUT_PULLUP);
-    attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), handleButtonPress, FALLING);
+    Board::Leds::begin();
+    Board::Button::begin();
+    attachInterrupt(digitalPinToInterrupt(Board::BUTTON_PIN), handleButtonPress, FALLING);
     Serial.begin(9600);
     Serial.println("[SYSTEM] Initializing hardware...");
 }
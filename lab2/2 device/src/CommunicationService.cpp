@@ -1,4 +1,5 @@
 #include "CommunicationService.h"
+#include <TraceRecorder.h>
 
 CommunicationService::CommunicationService(SoftwareSerial& serial, uint32_t baudRate)
     : communicationSerial(serial), baudRate(baudRate)
@@ -13,6 +14,7 @@ void CommunicationService::init()
 void CommunicationService::send(ToogleCommand command)
 {
     communicationSerial.write((uint8_t)command);
+    TRACE_EVENT(TRACE_SERIAL_TX, (uint8_t)command, 0);
     Serial.print("Sent data: ");
     Serial.println((uint8_t)command);
 }
@@ -22,6 +24,7 @@ void CommunicationService::onReceive(CommandDelegate commandDelegate)
     if (communicationSerial.available())
     {
         int receivedData = communicationSerial.read(); 
+        TRACE_EVENT(TRACE_SERIAL_RX, receivedData, 0);
         Serial.print("Received data: ");
         Serial.println(receivedData);
         
@@ -3,18 +3,23 @@
 #include <ESP8266WebServer.h>
 #include "CommunicationService.h"
 #include <WebSocketsServer.h> 
+#include <BoardPins.h>
+#include <AllocTracker.h>
+#include <TraceRecorder.h>
 
-#define BUTTON_PIN D3
-#define LED1 D5
-#define LED2 D2
-#define LED3 D1
+using Board = Lab2Device2Board;
+
+// The *_trace env raises this so trace output does not queue behind a slow UART.
+#ifndef BAUND_RATE
+#define BAUND_RATE 9600
+#endif
 
 const char* apSSID = "ESP8266-AP";
 const char* apPassword = "123456789";
 
 ESP8266WebServer server(80);
 WebSocketsServer webSocket(81);
-SoftwareSerial mySerial(D7, D6, false);
+SoftwareSerial mySerial(Board::SERIAL_RX, Board::SERIAL_TX, false);
 CommunicationService communicationService(mySerial, 115200);
 
 const uint32_t STOP_DURATION = 15000;
@@ -24,10 +29,9 @@ volatile bool buttonPressed = false;
 volatile uint32_t lastInterruptTime = 0;
 
 void IRAM_ATTR handleButton() {
-    uint32_t interruptTime = millis();
-    if (interruptTime - lastInterruptTime > 200) {
+    TRACE_EVENT(TRACE_BUTTON, 0, 0);
+    if (Board::Button::accept(millis(), lastInterruptTime)) {
         buttonPressed = true;
-        lastInterruptTime = interruptTime;
 
         if (!isStopped) {
             Serial.println("Button pressed! Sending STOP command...");
@@ -37,17 +41,16 @@ void IRAM_ATTR handleButton() {
 }
 
 void setupPins() {
-    pinMode(BUTTON_PIN, INPUT_PULLUP);
-    pinMode(LED1, OUTPUT);
-    pinMode(LED2, OUTPUT);
-    pinMode(LED3, OUTPUT);
+    Board::Button::begin();
+    Board::Leds::begin();
 }
 
 void sendLEDState() {
-    String message = String(digitalRead(LED1)) + "," +
-                     String(digitalRead(LED2)) + "," +
-                     String(digitalRead(LED3));
-    webSocket.broadcastTXT(message);
+    TRACK_ALLOCATIONS("sendLEDState");
+    char message[6];
+    snprintf(message, sizeof(message), "%d,%d,%d",
+             Board::Leds::isOn(0), Board::Leds::isOn(1), Board::Leds::isOn(2));
+    webSocket.broadcastTXT(message, 5);
 }
 
 void setupWiFi() {
@@ -61,6 +64,7 @@ void setupWebSocket() {
     sendLEDState();
     webSocket.onEvent([](uint8_t num, WStype_t type, uint8_t * payload, size_t length) {
         if (type == WStype_TEXT) {
+            TRACE_EVENT(TRACE_WEBSOCKET, num, length);
             String command = String((char*)payload);
             if (command == "TOGGLE") {
                 buttonPressed = true;
@@ -72,6 +76,7 @@ void setupWebSocket() {
 
 void setupServer() {
     server.on("/", []() {
+        TRACE_REQUEST(server);
         server.send(200, "text/html",
           "<!DOCTYPE html>"
           "<html>"
@@ -109,12 +114,14 @@ void setupServer() {
     });
 
     server.on("/stopLEDs", []() {
+        TRACE_REQUEST(server);
         buttonPressed = true;
         communicationService.send(ToogleCommand::STOP);
         server.send(200, "text/plain", "LEDs will stop for 15 seconds.");
     });
 
     server.on("/simulateRemote", []() {
+        TRACE_REQUEST(server);
         communicationService.send(ToogleCommand::ON);
         server.send(200, "text/plain", "Simulated remote button press.");
     });
@@ -126,9 +133,7 @@ void handleButtonPress() {
     if (buttonPressed && !isStopped) {
         isStopped = true;
         stopTime = millis();
-        digitalWrite(LED1, LOW);
-        digitalWrite(LED2, LOW);
-        digitalWrite(LED3, LOW);
+        Board::Leds::allOff();
         sendLEDState();
         Serial.println("Button pressed! Stopping for 15 seconds...");
         buttonPressed = false;
@@ -152,9 +157,7 @@ void updateLEDs() {
     if (!isStopped && millis() - lastSwitchTime >= switchInterval) {
         lastSwitchTime = millis();
         ledState = (ledState + 1) % 3;
-        digitalWrite(LED1, ledState == 0 ? HIGH : LOW);
-        digitalWrite(LED2, ledState == 1 ? HIGH : LOW);
-        digitalWrite(LED3, ledState == 2 ? HIGH : LOW);
+        Board::Leds::only(ledState);
         sendLEDState();
         Serial.print("New State: ");
         Serial.println(ledState);
@@ -162,17 +165,18 @@ void updateLEDs() {
 }
 
 void setup() {
-    Serial.begin(9600);
+    Serial.begin(BAUND_RATE);
     setupPins();
     setupWiFi();
     setupWebSocket();
     setupServer();
     communicationService.init();
 
-    attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), handleButton, FALLING);
+    attachInterrupt(digitalPinToInterrupt(Board::BUTTON_PIN), handleButton, FALLING);
 }
 
 void loop() {
+    TRACE_LOOP();
     server.handleClient();
     webSocket.loop();
     handleButtonPress();
@@ -186,9 +190,7 @@ void loop() {
         if (command == ToogleCommand::STOP) {
             isStopped = true;
             stopTime = millis();
-            digitalWrite(LED1, LOW);
-            digitalWrite(LED2, LOW);
-            digitalWrite(LED3, LOW);
+            Board::Leds::allOff();
             Serial.println("Received STOP command! Stopping LEDs...");
         }
         if (command == ToogleCommand::ON) {
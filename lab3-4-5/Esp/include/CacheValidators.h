@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+#include <time.h>
+
+// Validators for /api/measurements: a weak ETag built from the storage
+// generation and the last record id, and Last-Modified from that record's
+// time. Both strings are formatted when a record is written, so answering
+// an idle poll is two string compares and no file access.
+//
+// The generation is bumped on every boot because setup() recreates
+// colors.csv, so ids alone could repeat.
+//
+// Last-Modified is only sent for records stamped after SYNCED_AFTER. The
+// board runs a soft AP and rarely reaches NTP, so time() usually counts from
+// boot; those dates repeat after every reboot and could answer a client
+// that only sends If-Modified-Since with a false 304.
+class CacheValidators
+{
+public:
+  static const time_t SYNCED_AFTER = 1600000000;  // 2020-09-13
+
+  CacheValidators();
+  void reset(uint32_t generation);
+  void recordWritten(uint32_t id, time_t createdAt);
+  uint32_t lastId() const;
+
+  const char* etag() const;
+  const char* lastModified() const;
+  bool notModified(const char* ifNoneMatch, const char* ifModifiedSince) const;
+
+private:
+  uint32_t generation;
+  uint32_t lastRecordId;
+  char etagText[32];
+  char lastModifiedText[32];
+
+  void formatEtag();
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+
+#define TCS34725_COMMAND_BIT 0x80
+#define TCS34725_AUTO_INCREMENT 0x20
+#define TCS34725_CLEAR_INT 0x66
+
+#define TCS34725_ENABLE 0x00
+#define TCS34725_ENABLE_PON 0x01
+#define TCS34725_ENABLE_AEN 0x02
+#define TCS34725_ENABLE_AIEN 0x10
+#define TCS34725_ATIME 0x01
+#define TCS34725_AILTL 0x04
+#define TCS34725_PERS 0x0C
+#define TCS34725_CONTROL 0x0F
+#define TCS34725_ID 0x12
+#define TCS34725_STATUS 0x13
+#define TCS34725_STATUS_AVALID 0x01
+#define TCS34725_STATUS_AINT 0x10
+#define TCS34725_CDATAL 0x14
+
+#define TCS34725_ATIME_600MS 0x06
+#define TCS34725_GAIN_X1 0x00
+
+// Register-level TCS34725 driver. All four channels are fetched in one
+// auto-increment burst (CDATAL..BDATAH) and poll() never waits on the sensor.
+// Once per integration cycle poll() reads STATUS; the channels are only
+// fetched when the clear-channel interrupt fired, i.e. the scene moved by
+// more than the configured delta for PERS consecutive cycles, or when the
+// caller asks for a reading anyway. The thresholds are then re-armed around
+// the new clear value.
+class ColorSensor
+{
+public:
+  ColorSensor(TwoWire& wire, uint8_t address, uint8_t atime, uint8_t gain);
+  bool init();
+  void setChangeThreshold(uint16_t delta, uint8_t persistence);
+  bool poll(uint32_t now, bool readAnyway = false);
+  bool changed() const;
+
+  uint16_t red() const;
+  uint16_t green() const;
+  uint16_t blue() const;
+  uint16_t clear() const;
+
+private:
+  TwoWire& wire;
+  uint8_t address;
+  uint8_t atime;
+  uint8_t gain;
+  uint32_t integrationMs;
+  uint32_t lastRead;
+  uint16_t threshold;
+  uint8_t persistence;
+  bool changedFlag;
+  uint16_t channels[4];
+
+  void write8(uint8_t reg, uint8_t value);
+  uint8_t read8(uint8_t reg);
+  bool readBurst(uint8_t reg, uint8_t* data, uint8_t length);
+  void armThresholds(uint16_t around);
+  void clearInterrupt();
+};
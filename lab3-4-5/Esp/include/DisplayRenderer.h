@@ -0,0 +1,40 @@
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+
+// Pushes only the changed parts of the SSD1306 frame buffer to the panel.
+// Drawing still goes through the Adafruit_SSD1306 API; the renderer keeps a
+// shadow copy of what the panel shows and sends just the column span that
+// differs on each 8-pixel page. At most one page goes out per service() call,
+// so a redraw never holds the shared I2C bus for longer than one page.
+class DisplayRenderer
+{
+public:
+  static const uint8_t PANEL_WIDTH = 128;
+  static const uint8_t PAGE_COUNT = 8;
+
+  DisplayRenderer(Adafruit_SSD1306& display, TwoWire& wire, uint8_t address, uint8_t maxFps);
+  void init();
+  void requestFrame();
+  bool service(uint32_t now);
+  bool isBusy() const;
+  uint32_t bytesSent() const;
+
+private:
+  static const uint8_t WIRE_CHUNK = 31;
+
+  Adafruit_SSD1306& display;
+  TwoWire& wire;
+  uint8_t address;
+  uint32_t frameInterval;
+  uint32_t lastFrameStart;
+  bool framePending;
+  bool frameActive;
+  uint8_t nextPage;
+  uint8_t shadow[PAGE_COUNT][PANEL_WIDTH];
+  uint32_t totalBytes;
+
+  bool findDirtySpan(const uint8_t* page, const uint8_t* shown, uint8_t& first, uint8_t& last) const;
+  void sendSpan(uint8_t page, uint8_t first, uint8_t last);
+};
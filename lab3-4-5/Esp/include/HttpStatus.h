@@ -0,0 +1,7 @@
+#pragma once
+
+#define HTTP_OK 200
+#define HTTP_NO_CONTENT 204
+#define HTTP_NOT_MODIFIED 304
+#define HTTP_NOT_FOUND 404
+#define HTTP_INTERNAL_ERROR 500
@@ -0,0 +1,32 @@
+#pragma once
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include "CacheValidators.h"
+#include "MeasurementLog.h"
+
+// GET /api/measurements. Answers 304 from the cache validators before
+// touching the file, otherwise streams the log as JSON, from the row after
+// ?since=<id> if given. After the first request the handler itself
+// allocates nothing: headers and arguments are read through the server's
+// const String& accessors and the log stays open. ESP8266WebServer still
+// builds Strings for the request it parsed and for every header it sends.
+class MeasurementApi
+{
+public:
+  MeasurementApi(ESP8266WebServer& server, MeasurementLog& log, CacheValidators& validators);
+  void begin();
+  void handle();
+
+private:
+  ESP8266WebServer& server;
+  MeasurementLog& log;
+  CacheValidators& validators;
+  int ifNoneMatchHeader;
+  int ifModifiedSinceHeader;
+
+  int findCollectedHeader(const char* name) const;
+  const char* collectedHeader(int index) const;
+  uint32_t sinceArg() const;
+  bool sendCacheValidators();
+  static void sendChunk(void* context, const char* data, size_t length);
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <Arduino.h>
+#include <time.h>
+
+// Formats one colors.csv row, "id,red,green,blue,createdAt\n", into `buf`.
+// Returns the length written, or 0 if it did not fit.
+size_t formatMeasurementRow(char* buf, size_t size, uint32_t id,
+                            uint16_t red, uint16_t green, uint16_t blue, time_t createdAt);
+
+// Turns colors.csv rows into the JSON array served by /api/measurements.
+// Rows are parsed in place and collected in a fixed buffer that is handed to
+// `sink` whenever the next piece would not fit, so a response of any length
+// needs no heap. Rows with an id at or below `since` are skipped. `context`
+// is passed through to `sink`.
+class MeasurementJsonWriter
+{
+public:
+  typedef void (*Sink)(void* context, const char* data, size_t length);
+  static const size_t CHUNK_SIZE = 512;
+
+  MeasurementJsonWriter(Sink sink, void* context, uint32_t since);
+  void begin();
+  bool addRow(char* line);
+  void end();
+
+private:
+  Sink sink;
+  void* context;
+  uint32_t since;
+  bool first;
+  size_t used;
+  char out[CHUNK_SIZE];
+
+  void append(const char* data, size_t length);
+  void flush();
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include "CacheValidators.h"
+#include "MeasurementJson.h"
+#include "SampleCompressor.h"
+
+// colors.csv behind one handle, opened with mode "a+" at boot. Appends always
+// go to the end of the file whatever the read position, and stream() seeks
+// back to the start, so neither a sample nor a request opens a file (a
+// LittleFS handle and its buffers live on the heap). Each row is flushed
+// when written and recorded in the cache validators.
+class MeasurementLog
+{
+public:
+  explicit MeasurementLog(CacheValidators& validators);
+  void begin(const File& file);
+  bool isOpen() const;
+  size_t append(const ColorSample& sample);
+  const char* lastRow() const;
+  void stream(MeasurementJsonWriter& writer);
+
+private:
+  CacheValidators& validators;
+  File file;
+  char row[64];
+};
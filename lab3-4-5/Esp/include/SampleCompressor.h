@@ -0,0 +1,75 @@
+#pragma once
+#include <Arduino.h>
+#include <time.h>
+
+struct ColorSample
+{
+  uint32_t at;        // millis() when the reading was taken
+  time_t createdAt;   // wall-clock time written to storage
+  uint16_t red;
+  uint16_t green;
+  uint16_t blue;
+};
+
+struct CompressionConfig
+{
+  // Sample-and-hold mode: a reading is kept when any channel moved more than
+  // absoluteDeadband + relativeDeadband * |last kept|, or when the CIE76
+  // delta-E against the last kept colour exceeds deltaE. Zero disables a test.
+  uint16_t absoluteDeadband;
+  float relativeDeadband;
+  float deltaE;
+  // Swinging-door mode: kept points are vertices of a polyline that stays
+  // within absoluteDeadband counts of every reading on every channel.
+  bool swingingDoor;
+  // A point is kept at least this often, even if nothing changed.
+  uint32_t maxSilenceMs;
+  // Raw count that maps to 1.0 when converting to Lab.
+  uint16_t fullScale;
+};
+
+// Per-channel reconstruction error, in raw counts, for every reading:
+//   |actual - reconstructed| <= absolute + relative * reconstructed
+// In hold mode `reconstructed` is the last kept value, so a reader can
+// compute the bound of each point. With only a delta-E threshold the error
+// is bounded perceptually, not per channel, and `bounded` is false.
+struct ErrorBound
+{
+  float absolute;
+  float relative;
+  bool bounded;
+};
+
+// Decides which color readings are worth persisting. It is storage-agnostic
+// and can be used as a streaming filter: push() every reading and persist
+// `out` whenever it returns true.
+//
+// Readers reconstruct the series by holding the last kept value (deadband
+// mode) or by linear interpolation between kept points (swinging door).
+class SampleCompressor
+{
+public:
+  explicit SampleCompressor(const CompressionConfig& config);
+  bool push(const ColorSample& sample, ColorSample& out);
+  bool flush(ColorSample& out);
+  ErrorBound errorBound() const;
+  const CompressionConfig& config() const;
+
+private:
+  CompressionConfig settings;
+  bool hasArchive;
+  bool hasPending;
+  ColorSample archive;
+  ColorSample pending;
+  float slopeLow[3];
+  float slopeHigh[3];
+
+  bool pushDeadband(const ColorSample& sample, ColorSample& out);
+  bool pushSwingingDoor(const ColorSample& sample, ColorSample& out);
+  void openDoor();
+  bool narrowDoor(const ColorSample& sample);
+  ColorSample closeDoor() const;
+  bool exceedsDeadband(const ColorSample& sample) const;
+  float deltaE(const ColorSample& a, const ColorSample& b) const;
+  void toLab(const ColorSample& sample, float lab[3]) const;
+};
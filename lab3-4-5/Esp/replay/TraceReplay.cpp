@@ -0,0 +1,454 @@
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include <AllocTracker.h>
+#include <algorithm>
+#include <vector>
+#include "ColorSensor.h"
+#include "DisplayRenderer.h"
+#include "SampleCompressor.h"
+#include "CacheValidators.h"
+#include "MeasurementLog.h"
+#include "MeasurementApi.h"
+#include "HttpStatus.h"
+
+// Deterministic host replay of a d1_mini_trace recording:
+//
+//   pio run -e native_replay
+//   .pio/build/native_replay/program colors.trace > replay.json
+//
+// The firmware modules run against the fakes in test/fakes on a virtual
+// clock that advances 1 ms per loop, as main.cpp's loop() would:
+//   @E,<ms>,S,...  the recorded reading is latched into a register-level
+//                  TCS34725 at <ms>; it raises the interrupt when its clear
+//                  value is outside the thresholds ColorSensor armed, so
+//                  ColorSensor, SampleCompressor, MeasurementLog and
+//                  CacheValidators see the recorded scene.
+//   @H,<ms>,...    GET /api/measurements is sent to MeasurementApi::handle()
+//                  with the recorded ?since= and conditional headers.
+// Prints one JSON object with loop and response latency (host time, not
+// device time), modelled I2C bus time, compression and heap allocations.
+//
+// Button, serial and WebSocket events (@E B/R/T/W, recorded by lab2/2),
+// requests to other URIs and the recorded @L/@M statistics are counted
+// but not replayed. Lines recorded slightly out of order are applied when
+// reached; the clock never goes back.
+
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 64
+#define OLED_ADDRESS 0x3C
+#define TCS34725_ADDRESS 0x29
+#define DISPLAY_MAX_FPS 4
+#define I2C_CLOCK 400000
+#define COLOR_CHANGE_DELTA 40
+#define COLOR_CHANGE_PERSISTENCE 2
+#define SAMPLE_INTERVAL 5000
+
+#define COMPRESSION_DEADBAND 40
+#define COMPRESSION_RELATIVE 0.02f
+#define COMPRESSION_DELTA_E 2.3f
+#define COMPRESSION_SWINGING_DOOR false
+#define COMPRESSION_MAX_SILENCE 300000
+#define COMPRESSION_FULL_SCALE 65535
+
+// createdAt of a sample taken at millis() == 0. A synced clock, so the
+// replayed responses carry Last-Modified as well as the ETag.
+#define REPLAY_EPOCH 1760000000
+
+#define TRACE_LINE_SIZE 512
+#define TRACE_FIELDS 8
+
+#ifndef ALLOC_TRACKING
+#error "Build the replay with the native_replay env (-DALLOC_TRACKING and --wrap)"
+#endif
+
+// TCS34725 whose channels only change when the trace says so.
+class ReplayTcs34725 : public FakeI2cDevice
+{
+public:
+  uint8_t regs[0x20];
+
+  ReplayTcs34725()
+  {
+    memset(regs, 0, sizeof(regs));
+    regs[TCS34725_ID] = 0x44;
+  }
+
+  void latch(uint16_t clear, uint16_t red, uint16_t green, uint16_t blue)
+  {
+    const uint16_t values[] = {clear, red, green, blue};
+    for (uint8_t i = 0; i < 4; i++) {
+      regs[TCS34725_CDATAL + i * 2] = values[i] & 0xFF;
+      regs[TCS34725_CDATAL + i * 2 + 1] = values[i] >> 8;
+    }
+    regs[TCS34725_STATUS] |= TCS34725_STATUS_AVALID;
+
+    uint16_t low = regs[TCS34725_AILTL] | regs[TCS34725_AILTL + 1] << 8;
+    uint16_t high = regs[TCS34725_AILTL + 2] | regs[TCS34725_AILTL + 3] << 8;
+    if ((regs[TCS34725_ENABLE] & TCS34725_ENABLE_AIEN) && (clear < low || clear > high)) {
+      regs[TCS34725_STATUS] |= TCS34725_STATUS_AINT;
+    }
+  }
+
+  void receive(const uint8_t* data, size_t length) override
+  {
+    if (length == 0 || !(data[0] & TCS34725_COMMAND_BIT)) return;
+    uint8_t type = data[0] & 0x60;
+    if (type == 0x60) {
+      if ((data[0] & 0x1F) == (TCS34725_CLEAR_INT & 0x1F)) regs[TCS34725_STATUS] &= ~TCS34725_STATUS_AINT;
+      return;
+    }
+    pointer = data[0] & 0x1F;
+    autoIncrement = type == TCS34725_AUTO_INCREMENT;
+    for (size_t i = 1; i < length; i++) {
+      if (pointer < TCS34725_ID) regs[pointer] = data[i];
+      if (autoIncrement) pointer++;
+    }
+  }
+
+  size_t transmit(uint8_t* data, size_t length) override
+  {
+    for (size_t i = 0; i < length; i++) {
+      data[i] = regs[(pointer + (autoIncrement ? i : 0)) & 0x1F];
+    }
+    return length;
+  }
+
+private:
+  uint8_t pointer = 0;
+  bool autoIncrement = false;
+};
+
+struct Latencies
+{
+  std::vector<uint32_t> ns;
+
+  void print(const char* name) const
+  {
+    std::vector<uint32_t> sorted(ns);
+    std::sort(sorted.begin(), sorted.end());
+    printf("  \"%s\": {\"count\": %zu", name, sorted.size());
+    if (!sorted.empty()) {
+      static const char* labels[] = {"p50Us", "p95Us", "p99Us"};
+      static const double ranks[] = {0.50, 0.95, 0.99};
+      for (uint8_t i = 0; i < 3; i++) {
+        printf(", \"%s\": %.3f", labels[i], sorted[(size_t)(ranks[i] * (sorted.size() - 1))] / 1000.0);
+      }
+      printf(", \"maxUs\": %.3f", sorted.back() / 1000.0);
+    }
+    printf("}");
+  }
+};
+
+struct Skipped
+{
+  uint32_t button = 0;
+  uint32_t serialRx = 0;
+  uint32_t serialTx = 0;
+  uint32_t websocket = 0;
+  uint32_t otherRequests = 0;
+  uint32_t recordedStats = 0;
+  uint32_t malformed = 0;
+};
+
+static TwoWire bus;
+static ReplayTcs34725 chip;
+static ColorSensor sensor(bus, TCS34725_ADDRESS, TCS34725_ATIME_600MS, TCS34725_GAIN_X1);
+static Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &bus, -1, I2C_CLOCK, I2C_CLOCK);
+static DisplayRenderer renderer(display, bus, OLED_ADDRESS, DISPLAY_MAX_FPS);
+static SampleCompressor compressor({
+  COMPRESSION_DEADBAND, COMPRESSION_RELATIVE, COMPRESSION_DELTA_E,
+  COMPRESSION_SWINGING_DOOR, COMPRESSION_MAX_SILENCE, COMPRESSION_FULL_SCALE
+});
+static CacheValidators validators;
+static FakeFileData colors;
+static MeasurementLog measurementLog(validators);
+static ESP8266WebServer server;
+static MeasurementApi api(server, measurementLog, validators);
+
+static uint32_t lastSave = 0;
+static bool samplePending = false;
+
+static Latencies loopLatency;
+static Latencies responseLatency;
+static Skipped skipped;
+static uint32_t sensorEvents = 0;
+static uint32_t readings = 0;
+static uint32_t keptSamples = 0;
+static uint16_t maxError[3] = {0, 0, 0};
+static bool hasKept = false;
+static ColorSample lastKept;
+static uint32_t statusCounts[3] = {0, 0, 0};  // 200, 304, other
+static uint64_t responseBytes = 0;
+static AllocStats sampleAllocs = {0, 0};
+static AllocStats requestAllocs = {0, 0};
+static uint32_t maxRequestAllocs = 0;
+
+static uint64_t hostNowNs()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void addAllocs(AllocStats& total, const AllocStats& start)
+{
+  AllocStats end = allocSnapshot();
+  total.count += end.count - start.count;
+  total.bytes += end.bytes - start.bytes;
+}
+
+static uint16_t channelError(uint16_t actual, uint16_t held)
+{
+  return actual > held ? actual - held : held - actual;
+}
+
+// The sampling half of main.cpp's loop(), without the Serial output.
+static void sampleLoop()
+{
+  uint32_t currentMillis = millis();
+  if (sensor.poll(currentMillis, currentMillis - lastSave >= SAMPLE_INTERVAL)) {
+    readings++;
+    samplePending = true;
+    return;
+  }
+
+  if (samplePending) {
+    samplePending = false;
+    lastSave = currentMillis;
+
+    uint16_t r = sensor.red(), g = sensor.green(), b = sensor.blue();
+
+    display.clearDisplay();
+    display.getBuffer()[r % (SCREEN_WIDTH * SCREEN_HEIGHT / 8)] = 0xFF;
+    renderer.requestFrame();
+
+    AllocStats start = allocSnapshot();
+    ColorSample sample = {currentMillis, (time_t)(REPLAY_EPOCH + currentMillis / 1000), r, g, b};
+    ColorSample kept;
+    if (compressor.push(sample, kept)) {
+      if (measurementLog.append(kept) > 0) keptSamples++;
+      lastKept = kept;
+      hasKept = true;
+    }
+    addAllocs(sampleAllocs, start);
+
+    if (hasKept) {
+      maxError[0] = std::max(maxError[0], channelError(r, lastKept.red));
+      maxError[1] = std::max(maxError[1], channelError(g, lastKept.green));
+      maxError[2] = std::max(maxError[2], channelError(b, lastKept.blue));
+    }
+    return;
+  }
+
+  renderer.service(currentMillis);
+}
+
+static void runUntil(uint32_t ms)
+{
+  while (millis() < ms) {
+    uint64_t start = hostNowNs();
+    sampleLoop();
+    uint64_t elapsed = hostNowNs() - start;
+    loopLatency.ns.push_back(elapsed);
+    fakeNowUs += 1000;
+  }
+}
+
+static int hexValue(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+// Undoes TraceRecorder's percent-encoding in place.
+static void decodeField(char* text)
+{
+  char* out = text;
+  for (char* in = text; *in; in++) {
+    if (*in == '%' && hexValue(in[1]) >= 0 && hexValue(in[2]) >= 0) {
+      *out++ = (char)(hexValue(in[1]) << 4 | hexValue(in[2]));
+      in += 2;
+    } else {
+      *out++ = *in;
+    }
+  }
+  *out = '\0';
+}
+
+static size_t splitFields(char* line, char* fields[])
+{
+  line[strcspn(line, "\r\n")] = '\0';
+  size_t count = 0;
+  fields[count++] = line;
+  for (char* c = line; *c && count < TRACE_FIELDS; c++) {
+    if (*c == ',') {
+      *c = '\0';
+      fields[count++] = c + 1;
+    }
+  }
+  return count;
+}
+
+static void replaySensor(uint32_t a, uint32_t b)
+{
+  sensorEvents++;
+  chip.latch(b & 0xFFFF, a >> 16, a & 0xFFFF, b >> 16);
+}
+
+static void replayRequest(char* uri, const char* ifNoneMatch, const char* ifModifiedSince)
+{
+  char* query = strchr(uri, '?');
+  if (query) *query++ = '\0';
+  if (strcmp(uri, "/api/measurements") != 0) {
+    skipped.otherRequests++;
+    return;
+  }
+
+  server.beginRequest(HTTP_GET, uri);
+  while (query && *query) {
+    char* next = strchr(query, '&');
+    if (next) *next++ = '\0';
+    char* value = strchr(query, '=');
+    if (value) *value++ = '\0';
+    server.addArg(query, value ? value : "");
+    query = next;
+  }
+  if (*ifNoneMatch) server.setHeader("If-None-Match", ifNoneMatch);
+  if (*ifModifiedSince) server.setHeader("If-Modified-Since", ifModifiedSince);
+
+  AllocStats allocs = allocSnapshot();
+  uint64_t start = hostNowNs();
+  api.handle();
+  uint64_t elapsed = hostNowNs() - start;
+  uint32_t count = allocSnapshot().count - allocs.count;
+  addAllocs(requestAllocs, allocs);
+  maxRequestAllocs = std::max(maxRequestAllocs, count);
+  responseLatency.ns.push_back(elapsed);
+
+  statusCounts[server.status == HTTP_OK ? 0 : server.status == HTTP_NOT_MODIFIED ? 1 : 2]++;
+  responseBytes += server.headerBytes + server.bodyBytes;
+}
+
+static void replayLine(char* line)
+{
+  char* fields[TRACE_FIELDS];
+  size_t count = splitFields(line, fields);
+  if (strcmp(fields[0], "@L") == 0 || strcmp(fields[0], "@M") == 0) {
+    skipped.recordedStats++;
+    return;
+  }
+
+  bool event = strcmp(fields[0], "@E") == 0 && count == 5;
+  bool request = strcmp(fields[0], "@H") == 0 && count >= 5;
+  if (!event && !request) {
+    if (line[0] == '@') skipped.malformed++;
+    return;
+  }
+  runUntil(strtoul(fields[1], nullptr, 10));
+
+  if (request) {
+    for (size_t i = 3; i < count; i++) decodeField(fields[i]);
+    if (strtoul(fields[2], nullptr, 10) != HTTP_GET) {
+      skipped.otherRequests++;
+      return;
+    }
+    replayRequest(fields[3], count > 5 ? fields[5] : "", count > 6 ? fields[6] : "");
+    return;
+  }
+
+  uint32_t a = strtoul(fields[3], nullptr, 10);
+  uint32_t b = strtoul(fields[4], nullptr, 10);
+  switch (fields[2][0]) {
+    case 'S': replaySensor(a, b); break;
+    case 'B': skipped.button++; break;
+    case 'R': skipped.serialRx++; break;
+    case 'T': skipped.serialTx++; break;
+    case 'W': skipped.websocket++; break;
+    default: skipped.malformed++; break;
+  }
+}
+
+// The recorded ETags carry the generation the board booted with; reusing
+// it lets the recorded If-None-Match values match the replayed log.
+static uint32_t recordedGeneration(FILE* trace)
+{
+  char line[TRACE_LINE_SIZE];
+  uint32_t generation = 1;
+  while (fgets(line, sizeof(line), trace)) {
+    char* fields[TRACE_FIELDS];
+    size_t count = splitFields(line, fields);
+    if (strcmp(fields[0], "@H") != 0 || count < 6) continue;
+    decodeField(fields[5]);
+    if (sscanf(fields[5], "W/\"%u-", &generation) == 1) break;
+  }
+  rewind(trace);
+  return generation;
+}
+
+static void printReport(const char* path)
+{
+  printf("{\n");
+  printf("  \"trace\": \"%s\",\n", path);
+  printf("  \"virtualMs\": %u,\n", millis());
+  printf("  \"sensorEvents\": %u,\n", sensorEvents);
+  printf("  \"skipped\": {\"button\": %u, \"serialRx\": %u, \"serialTx\": %u, \"websocket\": %u, "
+         "\"otherRequests\": %u, \"recordedStats\": %u, \"malformed\": %u},\n",
+         skipped.button, skipped.serialRx, skipped.serialTx, skipped.websocket,
+         skipped.otherRequests, skipped.recordedStats, skipped.malformed);
+  loopLatency.print("loop");
+  printf(",\n");
+  responseLatency.print("response");
+  printf(",\n");
+  printf("  \"responses\": {\"ok\": %u, \"notModified\": %u, \"other\": %u, \"bytes\": %llu},\n",
+         statusCounts[0], statusCounts[1], statusCounts[2], (unsigned long long)responseBytes);
+  printf("  \"i2c\": {\"transactions\": %u, \"payloadBytes\": %u, \"busyMs\": %.3f},\n",
+         bus.transactions, bus.payloadBytes, bus.busyNs / 1e6);
+  printf("  \"compression\": {\"readings\": %u, \"kept\": %u, \"ratio\": %.3f, "
+         "\"maxError\": {\"red\": %u, \"green\": %u, \"blue\": %u}},\n",
+         readings, keptSamples, keptSamples ? (double)readings / keptSamples : 0.0,
+         maxError[0], maxError[1], maxError[2]);
+  printf("  \"heap\": {\"sampleAllocs\": %u, \"sampleBytes\": %u, \"requestAllocs\": %u, "
+         "\"requestBytes\": %u, \"maxAllocsPerRequest\": %u}\n",
+         sampleAllocs.count, sampleAllocs.bytes, requestAllocs.count, requestAllocs.bytes, maxRequestAllocs);
+  printf("}\n");
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <trace.log>\n", argv[0]);
+    return 2;
+  }
+  FILE* trace = fopen(argv[1], "r");
+  if (!trace) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  bus.attach(TCS34725_ADDRESS, &chip);
+  bus.setClock(I2C_CLOCK);
+  if (!sensor.init()) {
+    fprintf(stderr, "sensor init failed\n");
+    return 1;
+  }
+  sensor.setChangeThreshold(COLOR_CHANGE_DELTA, COLOR_CHANGE_PERSISTENCE);
+  display.begin(SSD1306_SWITCHCAPVCC, OLED_ADDRESS);
+  renderer.init();
+
+  const char* header = "ID,Red,Green,Blue,CreatedAt\n";
+  File file(&colors);
+  file.write((const uint8_t*)header, strlen(header));
+  validators.reset(recordedGeneration(trace));
+  measurementLog.begin(file);
+  api.begin();
+  bus.resetStats();
+
+  char line[TRACE_LINE_SIZE];
+  while (fgets(line, sizeof(line), trace)) replayLine(line);
+  fclose(trace);
+
+  printReport(argv[1]);
+  return 0;
+}
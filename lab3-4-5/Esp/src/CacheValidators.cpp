@@ -0,0 +1,55 @@
+#include "CacheValidators.h"
+
+CacheValidators::CacheValidators()
+  : generation(0), lastRecordId(0)
+{
+  reset(0);
+}
+
+void CacheValidators::reset(uint32_t generation)
+{
+  this->generation = generation;
+  lastRecordId = 0;
+  lastModifiedText[0] = '\0';
+  formatEtag();
+}
+
+void CacheValidators::recordWritten(uint32_t id, time_t createdAt)
+{
+  lastRecordId = id;
+  formatEtag();
+  if (createdAt > SYNCED_AFTER) {
+    strftime(lastModifiedText, sizeof(lastModifiedText), "%a, %d %b %Y %H:%M:%S GMT", gmtime(&createdAt));
+  }
+}
+
+uint32_t CacheValidators::lastId() const
+{
+  return lastRecordId;
+}
+
+const char* CacheValidators::etag() const
+{
+  return etagText;
+}
+
+// Empty until the first record is written.
+const char* CacheValidators::lastModified() const
+{
+  return lastModifiedText;
+}
+
+// If-None-Match decides on its own whenever it is present: If-Modified-Since
+// is ignored then, even if it matches. Either may be null or empty.
+bool CacheValidators::notModified(const char* ifNoneMatch, const char* ifModifiedSince) const
+{
+  if (ifNoneMatch && ifNoneMatch[0]) {
+    return strcmp(ifNoneMatch, etagText) == 0;
+  }
+  return lastModifiedText[0] && ifModifiedSince && strcmp(ifModifiedSince, lastModifiedText) == 0;
+}
+
+void CacheValidators::formatEtag()
+{
+  snprintf(etagText, sizeof(etagText), "W/\"%lu-%lu\"", (unsigned long)generation, (unsigned long)lastRecordId);
+}
@@ -0,0 +1,153 @@
+#include "ColorSensor.h"
+
+ColorSensor::ColorSensor(TwoWire& wire, uint8_t address, uint8_t atime, uint8_t gain)
+  : wire(wire), address(address), atime(atime), gain(gain),
+    integrationMs((256 - atime) * 24 / 10 + 1), lastRead(0),
+    threshold(0), persistence(0), changedFlag(false), channels{0, 0, 0, 0}
+{
+}
+
+bool ColorSensor::init()
+{
+  uint8_t id = read8(TCS34725_ID);
+  if (id != 0x44 && id != 0x4D && id != 0x10) {
+    return false;
+  }
+
+  write8(TCS34725_ATIME, atime);
+  write8(TCS34725_CONTROL, gain);
+  write8(TCS34725_PERS, persistence);
+  armThresholds(0);
+  clearInterrupt();
+
+  write8(TCS34725_ENABLE, TCS34725_ENABLE_PON);
+  delay(3);
+  write8(TCS34725_ENABLE, TCS34725_ENABLE_PON | TCS34725_ENABLE_AEN | TCS34725_ENABLE_AIEN);
+  lastRead = millis();
+  return true;
+}
+
+// persistence is the raw APERS field: 0 = every cycle, 1..3 = that many
+// cycles, 4..15 = 5, 10, 15 ... 60 consecutive out-of-range cycles.
+void ColorSensor::setChangeThreshold(uint16_t delta, uint8_t persistence)
+{
+  this->threshold = delta;
+  this->persistence = persistence & 0x0F;
+  write8(TCS34725_PERS, this->persistence);
+  armThresholds(channels[0]);
+}
+
+// Returns true when red()..clear() hold a new reading: after a threshold
+// interrupt (changed() is then true) or, with readAnyway, after any
+// completed cycle.
+bool ColorSensor::poll(uint32_t now, bool readAnyway)
+{
+  if (now - lastRead < integrationMs) {
+    return false;
+  }
+
+  uint8_t status = read8(TCS34725_STATUS);
+  if (!(status & TCS34725_STATUS_AVALID)) {
+    return false;
+  }
+
+  changedFlag = status & TCS34725_STATUS_AINT;
+  if (!changedFlag && !readAnyway) {
+    lastRead = now;
+    return false;
+  }
+
+  uint8_t data[8];
+  if (!readBurst(TCS34725_CDATAL, data, sizeof(data))) {
+    return false;
+  }
+  lastRead = now;
+
+  channels[0] = data[0] | (data[1] << 8);
+  channels[1] = data[2] | (data[3] << 8);
+  channels[2] = data[4] | (data[5] << 8);
+  channels[3] = data[6] | (data[7] << 8);
+
+  if (changedFlag) {
+    armThresholds(channels[0]);
+    clearInterrupt();
+  }
+  return true;
+}
+
+bool ColorSensor::changed() const
+{
+  return changedFlag;
+}
+
+uint16_t ColorSensor::red() const
+{
+  return channels[1];
+}
+
+uint16_t ColorSensor::green() const
+{
+  return channels[2];
+}
+
+uint16_t ColorSensor::blue() const
+{
+  return channels[3];
+}
+
+uint16_t ColorSensor::clear() const
+{
+  return channels[0];
+}
+
+void ColorSensor::write8(uint8_t reg, uint8_t value)
+{
+  wire.beginTransmission(address);
+  wire.write(TCS34725_COMMAND_BIT | reg);
+  wire.write(value);
+  wire.endTransmission();
+}
+
+uint8_t ColorSensor::read8(uint8_t reg)
+{
+  uint8_t value = 0;
+  readBurst(reg, &value, 1);
+  return value;
+}
+
+bool ColorSensor::readBurst(uint8_t reg, uint8_t* data, uint8_t length)
+{
+  wire.beginTransmission(address);
+  wire.write(TCS34725_COMMAND_BIT | TCS34725_AUTO_INCREMENT | reg);
+  if (wire.endTransmission(false) != 0) {
+    return false;
+  }
+  if (wire.requestFrom(address, length) != length) {
+    return false;
+  }
+  for (uint8_t i = 0; i < length; i++) {
+    data[i] = wire.read();
+  }
+  return true;
+}
+
+void ColorSensor::armThresholds(uint16_t around)
+{
+  uint16_t low = around > threshold ? around - threshold : 0;
+  uint16_t high = around < 0xFFFF - threshold ? around + threshold : 0xFFFF;
+
+  wire.beginTransmission(address);
+  wire.write(TCS34725_COMMAND_BIT | TCS34725_AUTO_INCREMENT | TCS34725_AILTL);
+  wire.write(low & 0xFF);
+  wire.write(low >> 8);
+  wire.write(high & 0xFF);
+  wire.write(high >> 8);
+  wire.endTransmission();
+}
+
+void ColorSensor::clearInterrupt()
+{
+  wire.beginTransmission(address);
+  wire.write(TCS34725_COMMAND_BIT | TCS34725_CLEAR_INT);
+  wire.endTransmission();
+}
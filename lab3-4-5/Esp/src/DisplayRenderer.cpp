@@ -0,0 +1,96 @@
+#include "DisplayRenderer.h"
+
+DisplayRenderer::DisplayRenderer(Adafruit_SSD1306& display, TwoWire& wire, uint8_t address, uint8_t maxFps)
+  : display(display), wire(wire), address(address),
+    frameInterval(maxFps > 0 ? 1000 / maxFps : 0), lastFrameStart(0),
+    framePending(false), frameActive(false), nextPage(0), totalBytes(0)
+{
+}
+
+void DisplayRenderer::init()
+{
+  display.display();
+  memcpy(shadow, display.getBuffer(), sizeof(shadow));
+  framePending = false;
+  frameActive = false;
+}
+
+void DisplayRenderer::requestFrame()
+{
+  framePending = true;
+}
+
+bool DisplayRenderer::service(uint32_t now)
+{
+  if (!frameActive) {
+    if (!framePending || now - lastFrameStart < frameInterval) {
+      return false;
+    }
+    framePending = false;
+    frameActive = true;
+    nextPage = 0;
+    lastFrameStart = now;
+  }
+
+  const uint8_t* buffer = display.getBuffer();
+  while (nextPage < PAGE_COUNT) {
+    uint8_t page = nextPage++;
+    uint8_t first, last;
+    if (findDirtySpan(buffer + page * PANEL_WIDTH, shadow[page], first, last)) {
+      sendSpan(page, first, last);
+      break;
+    }
+  }
+
+  frameActive = nextPage < PAGE_COUNT;
+  return frameActive;
+}
+
+bool DisplayRenderer::isBusy() const
+{
+  return frameActive;
+}
+
+uint32_t DisplayRenderer::bytesSent() const
+{
+  return totalBytes;
+}
+
+bool DisplayRenderer::findDirtySpan(const uint8_t* page, const uint8_t* shown, uint8_t& first, uint8_t& last) const
+{
+  int16_t lo = 0;
+  while (lo < PANEL_WIDTH && page[lo] == shown[lo]) lo++;
+  if (lo == PANEL_WIDTH) return false;
+
+  int16_t hi = PANEL_WIDTH - 1;
+  while (hi > lo && page[hi] == shown[hi]) hi--;
+
+  first = lo;
+  last = hi;
+  return true;
+}
+
+void DisplayRenderer::sendSpan(uint8_t page, uint8_t first, uint8_t last)
+{
+  display.ssd1306_command(SSD1306_PAGEADDR);
+  display.ssd1306_command(page);
+  display.ssd1306_command(page);
+  display.ssd1306_command(SSD1306_COLUMNADDR);
+  display.ssd1306_command(first);
+  display.ssd1306_command(last);
+  totalBytes += 6 * 2;
+
+  const uint8_t* src = display.getBuffer() + page * PANEL_WIDTH;
+  uint16_t x = first;
+  while (x <= last) {
+    uint8_t count = last - x + 1 > WIRE_CHUNK ? WIRE_CHUNK : last - x + 1;
+    wire.beginTransmission(address);
+    wire.write((uint8_t)0x40);
+    wire.write(src + x, count);
+    wire.endTransmission();
+    totalBytes += count + 1;
+    x += count;
+  }
+
+  memcpy(shadow[page] + first, src + first, last - first + 1);
+}
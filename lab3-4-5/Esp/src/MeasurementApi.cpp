@@ -0,0 +1,87 @@
+#include "MeasurementApi.h"
+#include "HttpStatus.h"
+
+MeasurementApi::MeasurementApi(ESP8266WebServer& server, MeasurementLog& log, CacheValidators& validators)
+  : server(server), log(log), validators(validators), ifNoneMatchHeader(-1), ifModifiedSinceHeader(-1)
+{
+}
+
+// The core keeps its own keys first (Authorization, and If-None-Match since
+// 3.0) and only the first key with a given name receives the value, so the
+// indices are looked up once here rather than assumed.
+void MeasurementApi::begin()
+{
+  const char* conditionalHeaders[] = {"If-None-Match", "If-Modified-Since"};
+  server.collectHeaders(conditionalHeaders, 2);
+  ifNoneMatchHeader = findCollectedHeader("If-None-Match");
+  ifModifiedSinceHeader = findCollectedHeader("If-Modified-Since");
+}
+
+void MeasurementApi::handle()
+{
+  if (sendCacheValidators()) {
+    return;
+  }
+
+  if (!log.isOpen()) {
+    server.send(HTTP_NOT_FOUND, "application/json", "{\"error\":\"File not found\"}");
+    return;
+  }
+
+  MeasurementJsonWriter writer(sendChunk, &server, sinceArg());
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(HTTP_OK, "application/json", "");
+  log.stream(writer);
+  server.sendContent("");
+}
+
+int MeasurementApi::findCollectedHeader(const char* name) const
+{
+  for (int i = 0; i < server.headers(); i++) {
+    if (server.headerName(i).equalsIgnoreCase(name)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// By index: header(name) would build a temporary String per request, as
+// both names are longer than String's inline buffer.
+const char* MeasurementApi::collectedHeader(int index) const
+{
+  return index >= 0 ? server.header(index).c_str() : "";
+}
+
+// ?since=<id> returns only newer rows so clients can poll incrementally.
+uint32_t MeasurementApi::sinceArg() const
+{
+  for (int i = 0; i < server.args(); i++) {
+    if (server.argName(i) == "since") {
+      return strtoul(server.arg(i).c_str(), nullptr, 10);
+    }
+  }
+  return 0;
+}
+
+// Sends the caching validators and answers 304 when the client already has
+// the current list.
+bool MeasurementApi::sendCacheValidators()
+{
+  server.sendHeader("Cache-Control", "no-cache");
+  server.sendHeader("ETag", validators.etag());
+  if (validators.lastModified()[0]) {
+    server.sendHeader("Last-Modified", validators.lastModified());
+  }
+
+  bool notModified = validators.notModified(collectedHeader(ifNoneMatchHeader),
+                                            collectedHeader(ifModifiedSinceHeader));
+  if (notModified) {
+    server.send(HTTP_NOT_MODIFIED);
+  }
+  return notModified;
+}
+
+void MeasurementApi::sendChunk(void* context, const char* data, size_t length)
+{
+  static_cast<ESP8266WebServer*>(context)->sendContent(data, length);
+}
@@ -0,0 +1,75 @@
+#include "MeasurementJson.h"
+
+size_t formatMeasurementRow(char* buf, size_t size, uint32_t id,
+                            uint16_t red, uint16_t green, uint16_t blue, time_t createdAt)
+{
+  char timestamp[25];
+  strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S.000Z", gmtime(&createdAt));
+  int length = snprintf(buf, size, "%lu,%u,%u,%u,%s\n", (unsigned long)id, red, green, blue, timestamp);
+  return length > 0 && (size_t)length < size ? length : 0;
+}
+
+MeasurementJsonWriter::MeasurementJsonWriter(Sink sink, void* context, uint32_t since)
+  : sink(sink), context(context), since(since), first(true), used(0)
+{
+}
+
+void MeasurementJsonWriter::begin()
+{
+  first = true;
+  used = 0;
+  append("[", 1);
+}
+
+// `line` is one row without the newline; it is modified. Returns false for
+// the header, blank, malformed or filtered rows.
+bool MeasurementJsonWriter::addRow(char* line)
+{
+  size_t length = strlen(line);
+  while (length > 0 && (line[length - 1] == '\r' || line[length - 1] == ' ')) length--;
+  line[length] = '\0';
+  if (length == 0 || strncmp(line, "ID", 2) == 0) return false;
+
+  char* fields[5] = {line};
+  uint8_t count = 1;
+  for (char* p = line; *p && count < 5; p++) {
+    if (*p == ',') {
+      *p = '\0';
+      fields[count++] = p + 1;
+    }
+  }
+  if (count < 5 || strtoul(fields[0], nullptr, 10) <= since) return false;
+
+  char record[128];
+  int written = snprintf(record, sizeof(record),
+                         "%s{\"id\":%s,\"red\":%s,\"green\":%s,\"blue\":%s,\"createdAt\":\"%s\"}",
+                         first ? "" : ",", fields[0], fields[1], fields[2], fields[3], fields[4]);
+  if (written <= 0 || written >= (int)sizeof(record)) return false;
+
+  first = false;
+  append(record, written);
+  return true;
+}
+
+void MeasurementJsonWriter::end()
+{
+  append("]", 1);
+  flush();
+}
+
+void MeasurementJsonWriter::append(const char* data, size_t length)
+{
+  if (used + length > sizeof(out)) {
+    flush();
+  }
+  memcpy(out + used, data, length);
+  used += length;
+}
+
+void MeasurementJsonWriter::flush()
+{
+  if (used > 0) {
+    sink(context, out, used);
+    used = 0;
+  }
+}
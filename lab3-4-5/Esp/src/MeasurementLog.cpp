@@ -0,0 +1,50 @@
+#include "MeasurementLog.h"
+
+MeasurementLog::MeasurementLog(CacheValidators& validators)
+  : validators(validators)
+{
+  row[0] = '\0';
+}
+
+void MeasurementLog::begin(const File& file)
+{
+  this->file = file;
+}
+
+bool MeasurementLog::isOpen() const
+{
+  return (bool)file;
+}
+
+// colors.csv is recreated on boot, so the next id is known without
+// rescanning the file. Returns the row length, or 0 if nothing was written.
+size_t MeasurementLog::append(const ColorSample& sample)
+{
+  uint32_t id = validators.lastId() + 1;
+  size_t length = formatMeasurementRow(row, sizeof(row), id, sample.red, sample.green, sample.blue,
+                                       sample.createdAt);
+  if (length == 0 || !file || file.write((const uint8_t*)row, length) != length) {
+    return 0;
+  }
+  file.flush();
+  validators.recordWritten(id, sample.createdAt);
+  return length;
+}
+
+const char* MeasurementLog::lastRow() const
+{
+  return row;
+}
+
+void MeasurementLog::stream(MeasurementJsonWriter& writer)
+{
+  char line[64];
+  file.seek(0);
+  writer.begin();
+  while (file.available()) {
+    size_t length = file.readBytesUntil('\n', line, sizeof(line) - 1);
+    line[length] = '\0';
+    writer.addRow(line);
+  }
+  writer.end();
+}
@@ -0,0 +1,200 @@
+#include "SampleCompressor.h"
+#include <math.h>
+
+namespace {
+
+uint16_t channel(const ColorSample& sample, uint8_t index)
+{
+  return index == 0 ? sample.red : index == 1 ? sample.green : sample.blue;
+}
+
+void setChannel(ColorSample& sample, uint8_t index, float value)
+{
+  uint16_t rounded = value <= 0 ? 0 : value >= 65535 ? 65535 : (uint16_t)lroundf(value);
+  if (index == 0) sample.red = rounded;
+  else if (index == 1) sample.green = rounded;
+  else sample.blue = rounded;
+}
+
+float labF(float t)
+{
+  return t > 0.008856f ? cbrtf(t) : 7.787f * t + 16.0f / 116.0f;
+}
+
+}
+
+SampleCompressor::SampleCompressor(const CompressionConfig& config)
+  : settings(config), hasArchive(false), hasPending(false), archive(), pending()
+{
+  openDoor();
+}
+
+bool SampleCompressor::push(const ColorSample& sample, ColorSample& out)
+{
+  if (!hasArchive) {
+    archive = sample;
+    hasArchive = true;
+    openDoor();
+    out = sample;
+    return true;
+  }
+  return settings.swingingDoor ? pushSwingingDoor(sample, out) : pushDeadband(sample, out);
+}
+
+bool SampleCompressor::flush(ColorSample& out)
+{
+  if (!hasPending) {
+    return false;
+  }
+  out = closeDoor();
+  archive = out;
+  hasPending = false;
+  openDoor();
+  return true;
+}
+
+// Swinging door vertices are rounded to whole counts, hence the extra half.
+ErrorBound SampleCompressor::errorBound() const
+{
+  if (settings.swingingDoor) {
+    return {settings.absoluteDeadband + 0.5f, 0.0f, true};
+  }
+  if (settings.absoluteDeadband > 0 || settings.relativeDeadband > 0) {
+    return {(float)settings.absoluteDeadband, settings.relativeDeadband, true};
+  }
+  return {0.0f, 0.0f, settings.deltaE <= 0};
+}
+
+const CompressionConfig& SampleCompressor::config() const
+{
+  return settings;
+}
+
+bool SampleCompressor::pushDeadband(const ColorSample& sample, ColorSample& out)
+{
+  bool deadbandEnabled = settings.absoluteDeadband > 0 || settings.relativeDeadband > 0;
+  bool keep = !deadbandEnabled && settings.deltaE <= 0;
+
+  if (deadbandEnabled && exceedsDeadband(sample)) keep = true;
+  if (settings.deltaE > 0 && deltaE(sample, archive) > settings.deltaE) keep = true;
+  if (settings.maxSilenceMs > 0 && sample.at - archive.at >= settings.maxSilenceMs) keep = true;
+
+  if (keep) {
+    archive = sample;
+    out = sample;
+  }
+  return keep;
+}
+
+bool SampleCompressor::pushSwingingDoor(const ColorSample& sample, ColorSample& out)
+{
+  if (sample.at == archive.at) {
+    return false;
+  }
+
+  if (!narrowDoor(sample)) {
+    // The new reading cannot share a segment with the pending ones: end the
+    // segment at the pending reading and start a new door from there.
+    out = closeDoor();
+    archive = out;
+    openDoor();
+    narrowDoor(sample);
+    pending = sample;
+    return true;
+  }
+
+  pending = sample;
+  hasPending = true;
+  if (settings.maxSilenceMs > 0 && sample.at - archive.at >= settings.maxSilenceMs) {
+    return flush(out);
+  }
+  return false;
+}
+
+void SampleCompressor::openDoor()
+{
+  for (uint8_t i = 0; i < 3; i++) {
+    slopeLow[i] = -INFINITY;
+    slopeHigh[i] = INFINITY;
+  }
+}
+
+// Tightens the range of slopes through the archived point that keep every
+// reading since then within the deviation. Returns false, leaving the door
+// untouched, when the range would become empty.
+bool SampleCompressor::narrowDoor(const ColorSample& sample)
+{
+  float dt = sample.at - archive.at;
+  float deviation = settings.absoluteDeadband;
+  float low[3], high[3];
+
+  for (uint8_t i = 0; i < 3; i++) {
+    float delta = (float)channel(sample, i) - channel(archive, i);
+    low[i] = fmaxf(slopeLow[i], (delta - deviation) / dt);
+    high[i] = fminf(slopeHigh[i], (delta + deviation) / dt);
+    if (low[i] > high[i]) {
+      return false;
+    }
+  }
+
+  memcpy(slopeLow, low, sizeof(low));
+  memcpy(slopeHigh, high, sizeof(high));
+  return true;
+}
+
+// Vertex at the pending reading's time, on the slope within the door that is
+// closest to the reading itself.
+ColorSample SampleCompressor::closeDoor() const
+{
+  ColorSample vertex = pending;
+  float dt = pending.at - archive.at;
+
+  for (uint8_t i = 0; i < 3; i++) {
+    float slope = ((float)channel(pending, i) - channel(archive, i)) / dt;
+    slope = fminf(fmaxf(slope, slopeLow[i]), slopeHigh[i]);
+    setChannel(vertex, i, channel(archive, i) + slope * dt);
+  }
+  return vertex;
+}
+
+bool SampleCompressor::exceedsDeadband(const ColorSample& sample) const
+{
+  for (uint8_t i = 0; i < 3; i++) {
+    float last = channel(archive, i);
+    float band = settings.absoluteDeadband + settings.relativeDeadband * last;
+    if (fabsf((float)channel(sample, i) - last) > band) {
+      return true;
+    }
+  }
+  return false;
+}
+
+float SampleCompressor::deltaE(const ColorSample& a, const ColorSample& b) const
+{
+  float labA[3], labB[3];
+  toLab(a, labA);
+  toLab(b, labB);
+
+  float dL = labA[0] - labB[0];
+  float da = labA[1] - labB[1];
+  float db = labA[2] - labB[2];
+  return sqrtf(dL * dL + da * da + db * db);
+}
+
+// Treats normalized counts as linear sRGB and converts to CIE Lab (D65).
+void SampleCompressor::toLab(const ColorSample& sample, float lab[3]) const
+{
+  float scale = settings.fullScale > 0 ? settings.fullScale : 65535;
+  float r = fminf(sample.red / scale, 1.0f);
+  float g = fminf(sample.green / scale, 1.0f);
+  float b = fminf(sample.blue / scale, 1.0f);
+
+  float x = (0.4124f * r + 0.3576f * g + 0.1805f * b) / 0.95047f;
+  float y = 0.2126f * r + 0.7152f * g + 0.0722f * b;
+  float z = (0.0193f * r + 0.1192f * g + 0.9505f * b) / 1.08883f;
+
+  float fx = labF(x), fy = labF(y), fz = labF(z);
+  lab[0] = 116.0f * fy - 16.0f;
+  lab[1] = 500.0f * (fx - fy);
+  lab[2] = 200.0f * (fy - fz);
+}
@@ -1,110 +1,130 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
-#include <Adafruit_TCS34725.h>
 #include <LittleFS.h>
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
 #include <time.h>
-
-
-#define HTTP_OK 200
-#define HTTP_NO_CONTENT 204
-#define HTTP_NOT_FOUND 404
-#define HTTP_INTERNAL_ERROR 500
+#include "DisplayRenderer.h"
+#include "ColorSensor.h"
+#include "SampleCompressor.h"
+#include "CacheValidators.h"
+#include "MeasurementLog.h"
+#include "MeasurementApi.h"
+#include "HttpStatus.h"
+#include <BoardPins.h>
+#include <AllocTracker.h>
+#include <TraceRecorder.h>
 
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define OLED_RESET -1
 
-#define I2C_SDA D6
-#define I2C_SCL D5
 #define OLED_ADDRESS 0x3C
 #define TCS34725_ADDRESS 0x29
-
+#define DISPLAY_MAX_FPS 4
+#define I2C_CLOCK 400000
+#define COLOR_CHANGE_DELTA 40
+#define COLOR_CHANGE_PERSISTENCE 2
+
+#define COMPRESSION_DEADBAND 40
+#define COMPRESSION_RELATIVE 0.02f
+#define COMPRESSION_DELTA_E 2.3f
+#define COMPRESSION_SWINGING_DOOR false
+#define COMPRESSION_MAX_SILENCE 300000
+#define COMPRESSION_FULL_SCALE 65535
+
+#ifndef BAUND_RATE
 #define BAUND_RATE 115200
+#endif
 
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
-Adafruit_TCS34725 tcs = Adafruit_TCS34725(TCS34725_INTEGRATIONTIME_600MS, TCS34725_GAIN_1X);
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET, I2C_CLOCK, I2C_CLOCK);
+DisplayRenderer renderer(display, Wire, OLED_ADDRESS, DISPLAY_MAX_FPS);
+ColorSensor tcs(Wire, TCS34725_ADDRESS, TCS34725_ATIME_600MS, TCS34725_GAIN_X1);
 ESP8266WebServer server(80);
-
-uint8_t lastSave = 0;
-const uint8_t interval = 5000;
-
-String getTimestamp() {
-  time_t now = time(nullptr);
-  struct tm* t = gmtime(&now);
-  char buf[25];
-  sprintf(buf, "%04d-%02d-%02dT%02d:%02d:%02d.000Z",
-          t->tm_year + 1900, t->tm_mon + 1, t->tm_mday,
-          t->tm_hour, t->tm_min, t->tm_sec);
-  return String(buf);
-}
+SampleCompressor compressor({
+  COMPRESSION_DEADBAND, COMPRESSION_RELATIVE, COMPRESSION_DELTA_E,
+  COMPRESSION_SWINGING_DOOR, COMPRESSION_MAX_SILENCE, COMPRESSION_FULL_SCALE
+});
+
+// A sample is taken every `interval`, as before, and also as soon as the
+// sensor reports a brightness change. The interrupt only watches the clear
+// channel, so the fixed cadence is what catches colour changes at constant
+// brightness.
+uint32_t lastSave = 0;
+const uint32_t interval = 5000;
+bool samplePending = false;
+
+CacheValidators validators;
+MeasurementLog measurementLog(validators);
+MeasurementApi measurementApi(server, measurementLog, validators);
 
 void sendCorsHeaders() {
   server.sendHeader("Access-Control-Allow-Origin", "*");
   server.sendHeader("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
-  server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
+  server.sendHeader("Access-Control-Allow-Headers", "Content-Type, If-None-Match, If-Modified-Since");
+  server.sendHeader("Access-Control-Expose-Headers", "ETag, Last-Modified");
+}
+
+uint32_t bumpStorageGeneration() {
+  uint32_t generation = 0;
+  File file = LittleFS.open("/generation", "r");
+  if (file) {
+    file.read((uint8_t*)&generation, sizeof(generation));
+    file.close();
+  }
+  generation++;
+  file = LittleFS.open("/generation", "w");
+  if (file) {
+    file.write((const uint8_t*)&generation, sizeof(generation));
+    file.close();
+  }
+  return generation;
 }
 
 void handleRoot() {
+  TRACE_REQUEST(server);
   sendCorsHeaders();
   server.send(HTTP_OK, "text/plain", "Smart Color Logger is running.");
 }
 
-void handleAllMeasurements() {
-  if (!LittleFS.exists("/colors.csv")) {
-    sendCorsHeaders();
-    server.send(HTTP_NOT_FOUND, "application/json", "{\"error\":\"File not found\"}");
-    return;
-  }
-
-  File file = LittleFS.open("/colors.csv", "r");
-  if (!file) {
-    sendCorsHeaders();
-    server.send(HTTP_INTERNAL_ERROR, "application/json", "{\"error\":\"Read error\"}");
-    return;
+// Tells readers how to rebuild the full series from the stored points and
+// how far each rebuilt value may be from the reading it replaces:
+// absolute + relative * value, per channel. errorBound is null when only
+// the delta-E threshold applies.
+void handleCompressionInfo() {
+  TRACE_REQUEST(server);
+  const CompressionConfig& config = compressor.config();
+  ErrorBound bound = compressor.errorBound();
+  char errorBound[64] = "null";
+  if (bound.bounded) {
+    snprintf(errorBound, sizeof(errorBound), "{\"absolute\":%.2f,\"relative\":%.4f}",
+             bound.absolute, bound.relative);
   }
-
-  String json = "[";
-  bool first = true;
-
-  while (file.available()) {
-    String line = file.readStringUntil('\n');
-    line.trim();
-    if (line.length() == 0 || line.startsWith("ID")) continue;
-
-    uint8_t idIndex = line.indexOf(',');
-    uint8_t rIndex = line.indexOf(',', idIndex + 1);
-    uint8_t gIndex = line.indexOf(',', rIndex + 1);
-    uint8_t bIndex = line.indexOf(',', gIndex + 1);
-
-    String id = line.substring(0, idIndex);
-    String r = line.substring(idIndex + 1, rIndex);
-    String g = line.substring(rIndex + 1, gIndex);
-    String b = line.substring(gIndex + 1, bIndex);
-    String createdAt = line.substring(bIndex + 1);
-
-    if (!first) json += ",";
-    first = false;
-
-    json += "{\"id\":" + id + ",\"red\":" + r + ",\"green\":" + g + ",\"blue\":" + b + ",\"createdAt\":\"" + createdAt + "\"}";
-  }
-
-  json += "]";
-  file.close();
-
+  char json[192];
+  snprintf(json, sizeof(json),
+           "{\"reconstruction\":\"%s\",\"errorBound\":%s,\"deltaE\":%.2f,\"maxSilenceMs\":%lu}",
+           config.swingingDoor ? "linear" : "hold", errorBound,
+           config.deltaE, (unsigned long)config.maxSilenceMs);
   sendCorsHeaders();
   server.send(HTTP_OK, "application/json", json);
 }
 
+void handleAllMeasurements() {
+  TRACK_ALLOCATIONS("handleAllMeasurements");
+  TRACE_REQUEST(server);
+  sendCorsHeaders();
+  measurementApi.handle();
+}
+
 void handleOptionsRequest() {
   sendCorsHeaders();
   server.send(HTTP_NO_CONTENT);
 }
 
 void handleNotFound() {
+  TRACE_REQUEST(server);
   if (server.method() == HTTP_OPTIONS) {
     handleOptionsRequest();
   } else {
@@ -116,7 +136,8 @@ void handleNotFound() {
 void setup() 
 {
   Serial.begin(BAUND_RATE);
-  Wire.begin(I2C_SDA, I2C_SCL);
+  Wire.begin(ColorLoggerBoard::I2C_SDA, ColorLoggerBoard::I2C_SCL);
+  Wire.setClock(I2C_CLOCK);
 
   configTime(0, 0, "pool.ntp.org", "time.nist.gov");
 
@@ -129,11 +150,12 @@ void setup()
   display.setTextSize(1);
   display.setTextColor(SSD1306_WHITE);
 
-  if (!tcs.begin()) {
+  if (!tcs.init()) {
     display.println("TCS34725 not found");
     display.display();
     while (true);
   }
+  tcs.setChangeThreshold(COLOR_CHANGE_DELTA, COLOR_CHANGE_PERSISTENCE);
 
   if (!LittleFS.begin()) {
     Serial.println("FS error");
@@ -151,6 +173,8 @@ void setup()
   File file = LittleFS.open("/colors.csv", "w");
   file.println("ID,Red,Green,Blue,CreatedAt");
   file.close();
+  measurementLog.begin(LittleFS.open("/colors.csv", "a+"));
+  validators.reset(bumpStorageGeneration());
 
   WiFi.softAP("zalupka12", "postav10");
   IPAddress myIP = WiFi.softAPIP();
@@ -159,50 +183,56 @@ void setup()
   display.setCursor(0, 0);
   display.println("AP: ColorLogger");
   display.println(myIP.toString());
-  display.display();
+  renderer.init();
 
   Serial.println("WiFi AP started. IP:");
   Serial.println(myIP);
 
   server.on("/", handleRoot);
   server.on("/api/measurements", handleAllMeasurements);
+  server.on("/api/compression", handleCompressionInfo);
+  measurementApi.begin();
   server.onNotFound(handleNotFound);
   server.begin();
   Serial.println("Web server started");
 }
 
 void loop() {
+  TRACE_LOOP();
   server.handleClient();
 
   uint32_t currentMillis = millis();
-  if (currentMillis - lastSave >= interval) {
+  if (tcs.poll(currentMillis, currentMillis - lastSave >= interval)) {
+    TRACE_EVENT(TRACE_SENSOR, (uint32_t)tcs.red() << 16 | tcs.green(), (uint32_t)tcs.blue() << 16 | tcs.clear());
+    samplePending = true;
+    return;
+  }
+
+  if (samplePending) {
+    samplePending = false;
     lastSave = currentMillis;
 
-    static uint16_t r, g, b, c;
-    tcs.getRawData(&r, &g, &b, &c);
+    uint16_t r = tcs.red(), g = tcs.green(), b = tcs.blue();
 
     display.clearDisplay();
     display.setCursor(0, 0);
     display.printf("R:%d\nG:%d\nB:%d", r, g, b);
-    display.display();
+    renderer.requestFrame();
 
-    int nextId = 1;
-    File file = LittleFS.open("/colors.csv", "r");
-    while (file.available()) {
-      String line = file.readStringUntil('\n');
-      if (line.startsWith("ID")) continue;
-      nextId++;
+    ColorSample sample = {currentMillis, time(nullptr), r, g, b};
+    ColorSample kept;
+    if (!compressor.push(sample, kept)) {
+      return;
     }
-    file.close();
-
-    String timestamp = getTimestamp();
-    String line = String(nextId) + "," + r + "," + g + "," + b + "," + timestamp;
 
-    file = LittleFS.open("/colors.csv", "a");
-    if (file) {
-      file.println(line);
-      file.close();
-      Serial.println("Saved: " + line);
+    TRACK_ALLOCATIONS("saveSample");
+    size_t length = measurementLog.append(kept);
+    if (length > 0) {
+      Serial.print("Saved: ");
+      Serial.write((const uint8_t*)measurementLog.lastRow(), length);
     }
+    return;
   }
+
+  renderer.service(currentMillis);
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_WHITE 1
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+
+// Host stand-in for Adafruit_SSD1306 on I2C. display() and ssd1306_command()
+// put the same transactions on the bus as the library does with the
+// ESP8266 Wire buffer (WIRE_MAX = BUFFER_LENGTH), so byte counts and bus time
+// compare like for like.
+class Adafruit_SSD1306
+{
+public:
+  static const uint16_t WIRE_MAX = BUFFER_LENGTH;
+
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t = -1,
+                   uint32_t clkDuring = 400000UL, uint32_t = 100000UL)
+    : width(w), height(h), wire(twi), clock(clkDuring)
+  {
+    memset(buffer, 0, sizeof(buffer));
+  }
+
+  bool begin(uint8_t = SSD1306_SWITCHCAPVCC, uint8_t addr = 0x3C)
+  {
+    address = addr;
+    return true;
+  }
+
+  uint8_t* getBuffer()
+  {
+    return buffer;
+  }
+
+  void clearDisplay()
+  {
+    memset(buffer, 0, sizeof(buffer));
+  }
+
+  void display()
+  {
+    wire->setClock(clock);
+    static const uint8_t window[] = {SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0};
+    commandList(window, sizeof(window));
+    ssd1306_command(width - 1);
+
+    uint16_t count = width * ((height + 7) / 8);
+    const uint8_t* ptr = buffer;
+    wire->beginTransmission(address);
+    wire->write((uint8_t)0x40);
+    uint16_t bytesOut = 1;
+    while (count--) {
+      if (bytesOut >= WIRE_MAX) {
+        wire->endTransmission();
+        wire->beginTransmission(address);
+        wire->write((uint8_t)0x40);
+        bytesOut = 1;
+      }
+      wire->write(*ptr++);
+      bytesOut++;
+    }
+    wire->endTransmission();
+  }
+
+  void ssd1306_command(uint8_t c)
+  {
+    wire->beginTransmission(address);
+    wire->write((uint8_t)0x00);
+    wire->write(c);
+    wire->endTransmission();
+  }
+
+private:
+  uint8_t width;
+  uint8_t height;
+  TwoWire* wire;
+  uint32_t clock;
+  uint8_t address = 0x3C;
+  uint8_t buffer[128 * 64 / 8];
+
+  void commandList(const uint8_t* list, uint8_t count)
+  {
+    wire->beginTransmission(address);
+    wire->write((uint8_t)0x00);
+    wire->write(list, count);
+    wire->endTransmission();
+  }
+};
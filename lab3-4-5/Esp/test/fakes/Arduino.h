@@ -0,0 +1,110 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <time.h>
+#include <stdarg.h>
+
+// Just enough of the ESP8266 Arduino core to build the firmware modules on
+// the host for `pio test -e native`. Time only moves when a test moves it.
+
+#define IRAM_ATTR
+
+inline uint64_t fakeNowUs = 0;
+
+inline uint32_t millis()
+{
+  return fakeNowUs / 1000;
+}
+
+inline uint32_t micros()
+{
+  return fakeNowUs;
+}
+
+inline void delay(uint32_t ms)
+{
+  fakeNowUs += ms * 1000;
+}
+
+inline void delayMicroseconds(uint32_t us)
+{
+  fakeNowUs += us;
+}
+
+// Fixed-capacity String: enough for the firmware's const String& accessors
+// and never on the heap, so allocation tests count only the code under test.
+class String
+{
+public:
+  String(const char* text = "")
+  {
+    *this = text;
+  }
+
+  String& operator=(const char* text)
+  {
+    snprintf(buffer, sizeof(buffer), "%s", text ? text : "");
+    return *this;
+  }
+
+  const char* c_str() const { return buffer; }
+  unsigned int length() const { return strlen(buffer); }
+  bool equals(const char* other) const { return strcmp(buffer, other) == 0; }
+  bool equalsIgnoreCase(const char* other) const { return strcasecmp(buffer, other) == 0; }
+  bool operator==(const char* other) const { return equals(other); }
+
+private:
+  char buffer[128];
+};
+
+class FakeSerial
+{
+public:
+  bool quiet = true;
+
+  void begin(uint32_t) {}
+
+  int printf(const char* format, ...)
+  {
+    if (quiet) return 0;
+    va_list args;
+    va_start(args, format);
+    int written = vprintf(format, args);
+    va_end(args);
+    return written;
+  }
+
+  size_t print(const char* text)
+  {
+    return quiet ? 0 : fputs(text, stdout);
+  }
+
+  size_t println(const char* text)
+  {
+    return quiet ? 0 : puts(text);
+  }
+
+  size_t write(const uint8_t* data, size_t length)
+  {
+    return quiet ? 0 : fwrite(data, 1, length, stdout);
+  }
+};
+
+inline FakeSerial Serial;
+
+class FakeEsp
+{
+public:
+  uint32_t freeHeap = 40000;
+  uint32_t maxFreeBlock = 30000;
+
+  uint32_t getFreeHeap() const { return freeHeap; }
+  uint32_t getMaxFreeBlockSize() const { return maxFreeBlock; }
+};
+
+inline FakeEsp ESP;
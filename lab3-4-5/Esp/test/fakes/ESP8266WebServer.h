@@ -0,0 +1,141 @@
+#pragma once
+#include <Arduino.h>
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+// Host stand-in for ESP8266WebServer. A test sets up one request, calls a
+// handler and reads back the status, headers and body. Like the core,
+// collectHeaders() keeps the server's own keys (Authorization,
+// If-None-Match) ahead of the sketch's, and a header value only reaches the
+// first key with its name. Nothing here allocates, so allocation counts
+// cover the handler alone. The real server's Strings for the parsed request
+// and for every header it sends are not modelled.
+class ESP8266WebServer
+{
+public:
+  static const int MAX_HEADERS = 8;
+  static const int MAX_ARGS = 4;
+  static const size_t BODY_CAPACITY = 1 << 20;
+
+  int status = 0;
+  size_t headerBytes = 0;
+  size_t bodyBytes = 0;
+  char body[BODY_CAPACITY];
+
+  explicit ESP8266WebServer(int = 80)
+  {
+    headerKeys[0] = "Authorization";
+    headerKeys[1] = "If-None-Match";
+    headerCount = 2;
+  }
+
+  void collectHeaders(const char* keys[], size_t count)
+  {
+    headerCount = 2;
+    for (size_t i = 0; i < count && headerCount < MAX_HEADERS; i++) {
+      headerKeys[headerCount++] = keys[i];
+    }
+  }
+
+  // Test side: starts a new request and clears the last response.
+  void beginRequest(HTTPMethod method, const char* uri)
+  {
+    requestMethod = method;
+    requestUri = uri;
+    argCount = 0;
+    for (int i = 0; i < headerCount; i++) headerValues[i] = "";
+    status = 0;
+    headerBytes = 0;
+    bodyBytes = 0;
+    sentHeaderCount = 0;
+  }
+
+  void addArg(const char* name, const char* value)
+  {
+    if (argCount == MAX_ARGS) return;
+    argNames[argCount] = name;
+    argValues[argCount++] = value;
+  }
+
+  void setHeader(const char* name, const char* value)
+  {
+    for (int i = 0; i < headerCount; i++) {
+      if (headerKeys[i].equalsIgnoreCase(name)) {
+        headerValues[i] = value;
+        return;
+      }
+    }
+  }
+
+  // Value of a response header sent for the current request, or null.
+  const char* sentHeader(const char* name) const
+  {
+    for (int i = 0; i < sentHeaderCount; i++) {
+      if (sentNames[i].equalsIgnoreCase(name)) return sentValues[i].c_str();
+    }
+    return nullptr;
+  }
+
+  // Handler side.
+  const String& uri() const { return requestUri; }
+  HTTPMethod method() const { return requestMethod; }
+  int headers() const { return headerCount; }
+  const String& headerName(int i) const { return headerKeys[i]; }
+  const String& header(int i) const { return headerValues[i]; }
+  int args() const { return argCount; }
+  const String& argName(int i) const { return argNames[i]; }
+  const String& arg(int i) const { return argValues[i]; }
+
+  void sendHeader(const char* name, const char* value)
+  {
+    headerBytes += strlen(name) + strlen(value) + 4;
+    if (sentHeaderCount == MAX_SENT_HEADERS) return;
+    sentNames[sentHeaderCount] = name;
+    sentValues[sentHeaderCount++] = value;
+  }
+
+  void setContentLength(size_t) {}
+
+  void send(int code)
+  {
+    send(code, "", "");
+  }
+
+  void send(int code, const char* type, const char* content)
+  {
+    status = code;
+    headerBytes += strlen("HTTP/1.1 200 OK\r\nContent-Type: \r\n\r\n") + strlen(type);
+    sendContent(content, strlen(content));
+  }
+
+  void sendContent(const char* data, size_t length)
+  {
+    if (bodyBytes + length < BODY_CAPACITY) {
+      memcpy(body + bodyBytes, data, length);
+      body[bodyBytes + length] = '\0';
+    }
+    bodyBytes += length;
+  }
+
+  void sendContent(const char* data)
+  {
+    sendContent(data, strlen(data));
+  }
+
+private:
+  static const int MAX_SENT_HEADERS = 12;
+
+  HTTPMethod requestMethod = HTTP_GET;
+  String requestUri;
+  String headerKeys[MAX_HEADERS];
+  String headerValues[MAX_HEADERS];
+  int headerCount;
+  String argNames[MAX_ARGS];
+  String argValues[MAX_ARGS];
+  int argCount = 0;
+  String sentNames[MAX_SENT_HEADERS];
+  String sentValues[MAX_SENT_HEADERS];
+  int sentHeaderCount = 0;
+};
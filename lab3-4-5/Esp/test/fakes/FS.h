@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+
+// One in-memory LittleFS file of fixed capacity. Every File opened on it
+// shares the contents and keeps its own position. Writes always land at the
+// end, as with mode "a+", and reads follow seek().
+struct FakeFileData
+{
+  static const size_t CAPACITY = 1 << 20;
+  char bytes[CAPACITY];
+  size_t size = 0;
+};
+
+class File
+{
+public:
+  File() : data(nullptr), position(0) {}
+  explicit File(FakeFileData* data) : data(data), position(0) {}
+
+  operator bool() const
+  {
+    return data != nullptr;
+  }
+
+  size_t write(const uint8_t* buf, size_t length)
+  {
+    if (!data || data->size + length > FakeFileData::CAPACITY) return 0;
+    memcpy(data->bytes + data->size, buf, length);
+    data->size += length;
+    position = data->size;
+    return length;
+  }
+
+  void flush() {}
+
+  bool seek(uint32_t pos)
+  {
+    if (!data || pos > data->size) return false;
+    position = pos;
+    return true;
+  }
+
+  int available()
+  {
+    return data ? data->size - position : 0;
+  }
+
+  // Stream::readBytesUntil(): the terminator is consumed, not stored.
+  size_t readBytesUntil(char terminator, char* buf, size_t length)
+  {
+    size_t count = 0;
+    while (count < length && available() > 0) {
+      char c = data->bytes[position++];
+      if (c == terminator) break;
+      buf[count++] = c;
+    }
+    return count;
+  }
+
+  size_t size() const
+  {
+    return data ? data->size : 0;
+  }
+
+  void close()
+  {
+    data = nullptr;
+  }
+
+private:
+  FakeFileData* data;
+  size_t position;
+};
@@ -0,0 +1,131 @@
+#pragma once
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 128
+
+// A device on the fake bus. receive() gets the payload of each write
+// transaction, transmit() fills the payload of each read.
+class FakeI2cDevice
+{
+public:
+  virtual ~FakeI2cDevice() {}
+  virtual void receive(const uint8_t* data, size_t length) = 0;
+  virtual size_t transmit(uint8_t* data, size_t length) = 0;
+};
+
+// Host stand-in for TwoWire. Every transaction is timed as it would take on
+// the wire: START, address byte, payload bytes (9 clocks each with the ACK)
+// and STOP or repeated START, at the clock set with setClock().
+class TwoWire
+{
+public:
+  static const uint8_t MAX_DEVICES = 4;
+
+  uint32_t transactions = 0;
+  uint32_t payloadBytes = 0;
+  uint64_t busyNs = 0;
+
+  void begin(int = 0, int = 0) {}
+
+  void setClock(uint32_t hz)
+  {
+    clock = hz;
+  }
+
+  void attach(uint8_t address, FakeI2cDevice* device)
+  {
+    addresses[deviceCount] = address;
+    devices[deviceCount++] = device;
+  }
+
+  void resetStats()
+  {
+    transactions = 0;
+    payloadBytes = 0;
+    busyNs = 0;
+  }
+
+  void beginTransmission(uint8_t address)
+  {
+    target = address;
+    length = 0;
+  }
+
+  size_t write(uint8_t value)
+  {
+    if (length >= BUFFER_LENGTH) return 0;
+    buffer[length++] = value;
+    return 1;
+  }
+
+  size_t write(const uint8_t* data, size_t count)
+  {
+    size_t written = 0;
+    while (written < count && write(data[written])) written++;
+    return written;
+  }
+
+  uint8_t endTransmission(bool sendStop = true)
+  {
+    (void)sendStop;
+    FakeI2cDevice* device = find(target);
+    account(length);
+    if (!device) return 2;
+    device->receive(buffer, length);
+    return 0;
+  }
+
+  uint8_t requestFrom(uint8_t address, uint8_t count)
+  {
+    FakeI2cDevice* device = find(address);
+    readLength = 0;
+    readIndex = 0;
+    if (device) {
+      readLength = device->transmit(buffer, count < BUFFER_LENGTH ? count : BUFFER_LENGTH);
+    }
+    account(readLength);
+    return readLength;
+  }
+
+  int available()
+  {
+    return readLength - readIndex;
+  }
+
+  int read()
+  {
+    return readIndex < readLength ? buffer[readIndex++] : -1;
+  }
+
+  // Bus time of one transaction carrying `bytes` payload bytes.
+  uint64_t transactionNs(size_t bytes) const
+  {
+    return (uint64_t)((bytes + 1) * 9 + 2) * 1000000000ULL / clock;
+  }
+
+private:
+  uint32_t clock = 100000;
+  uint8_t addresses[MAX_DEVICES];
+  FakeI2cDevice* devices[MAX_DEVICES];
+  uint8_t deviceCount = 0;
+  uint8_t target = 0;
+  uint8_t buffer[BUFFER_LENGTH];
+  size_t length = 0;
+  size_t readLength = 0;
+  size_t readIndex = 0;
+
+  FakeI2cDevice* find(uint8_t address) const
+  {
+    for (uint8_t i = 0; i < deviceCount; i++) {
+      if (addresses[i] == address) return devices[i];
+    }
+    return nullptr;
+  }
+
+  void account(size_t bytes)
+  {
+    transactions++;
+    payloadBytes += bytes;
+    busyNs += transactionNs(bytes);
+  }
+};
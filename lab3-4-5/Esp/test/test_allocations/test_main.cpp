@@ -0,0 +1,178 @@
+#include <unity.h>
+#include <AllocTracker.h>
+#include "ColorSensor.h"
+#include "DisplayRenderer.h"
+#include "HttpStatus.h"
+#include "MeasurementApi.h"
+
+// Runs the sample path and the real /api/measurements handler with the
+// malloc/calloc/realloc counters from AllocTracker and checks that neither
+// touches the heap once warmed up. Needs the native_alloc env
+// (-DALLOC_TRACKING and the --wrap linker flags).
+//
+// The fake ESP8266WebServer does not allocate, so this covers the
+// firmware's own code. On the device ESP8266WebServer also allocates per
+// request: Strings for the parsed URI, arguments and collected header
+// values, and the response-header String that every sendHeader() and
+// send() appends to.
+
+#define SENSOR_ADDRESS 0x29
+#define OLED_ADDRESS 0x3C
+#define ITERATIONS 100
+
+// TCS34725 register file that always has a fresh reading and a pending
+// interrupt, so every poll() takes the full STATUS + burst + re-arm path.
+class BusySensor : public FakeI2cDevice
+{
+public:
+  uint8_t regs[0x20];
+  uint16_t clearValue = 1000;
+
+  BusySensor()
+  {
+    memset(regs, 0, sizeof(regs));
+    regs[TCS34725_ID] = 0x44;
+  }
+
+  void receive(const uint8_t* data, size_t length) override
+  {
+    if (length == 0 || (data[0] & 0x60) == 0x60) return;
+    pointer = data[0] & 0x1F;
+    for (size_t i = 1; i < length; i++) regs[(pointer + i - 1) & 0x1F] = data[i];
+  }
+
+  size_t transmit(uint8_t* data, size_t length) override
+  {
+    clearValue += 97;
+    regs[TCS34725_STATUS] = TCS34725_STATUS_AVALID | TCS34725_STATUS_AINT;
+    for (uint8_t i = 0; i < 4; i++) {
+      uint16_t value = clearValue / (i + 1);
+      regs[TCS34725_CDATAL + i * 2] = value & 0xFF;
+      regs[TCS34725_CDATAL + i * 2 + 1] = value >> 8;
+    }
+    for (size_t i = 0; i < length; i++) data[i] = regs[(pointer + i) & 0x1F];
+    return length;
+  }
+
+private:
+  uint8_t pointer = 0;
+};
+
+static TwoWire bus;
+static BusySensor chip;
+static ColorSensor sensor(bus, SENSOR_ADDRESS, TCS34725_ATIME_600MS, TCS34725_GAIN_X1);
+static Adafruit_SSD1306 display(128, 64, &bus);
+static DisplayRenderer renderer(display, bus, OLED_ADDRESS, 4);
+static SampleCompressor compressor({40, 0.02f, 2.3f, false, 300000, 65535});
+static CacheValidators validators;
+static FakeFileData colors;
+static MeasurementLog measurementLog(validators);
+static ESP8266WebServer server;
+static MeasurementApi api(server, measurementLog, validators);
+
+// The sampling half of loop(): poll, draw, compress, append to the log.
+static void samplePath()
+{
+  fakeNowUs += 700000;
+  uint32_t now = millis();
+  if (!sensor.poll(now, true)) return;
+
+  display.clearDisplay();
+  display.getBuffer()[sensor.red() % 1024] = 0xFF;
+  renderer.requestFrame();
+  while (renderer.service(millis())) fakeNowUs += 1000;
+
+  ColorSample sample = {now, (time_t)(1760000000 + now / 1000), sensor.red(), sensor.green(), sensor.blue()};
+  ColorSample kept;
+  if (!compressor.push(sample, kept)) return;
+
+  measurementLog.append(kept);
+}
+
+static char etag[32];
+static size_t responseBytes;
+
+// Three requests through MeasurementApi::handle(): a 304 on If-None-Match,
+// a full 200 list and an incremental ?since= poll.
+static void requestPath()
+{
+  server.beginRequest(HTTP_GET, "/api/measurements");
+  server.setHeader("If-None-Match", etag);
+  api.handle();
+  TEST_ASSERT_EQUAL(HTTP_NOT_MODIFIED, server.status);
+
+  server.beginRequest(HTTP_GET, "/api/measurements");
+  api.handle();
+  TEST_ASSERT_EQUAL(HTTP_OK, server.status);
+  responseBytes += server.bodyBytes;
+
+  server.beginRequest(HTTP_GET, "/api/measurements");
+  server.addArg("since", "10");
+  api.handle();
+  TEST_ASSERT_EQUAL(HTTP_OK, server.status);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_counters_see_heap_allocations(void)
+{
+  AllocStats start = allocSnapshot();
+  void* volatile block = malloc(16);
+  free(block);
+  uint8_t* volatile buffer = new uint8_t[16];
+  delete[] buffer;
+  TEST_ASSERT_EQUAL_UINT32(2, allocSnapshot().count - start.count);
+}
+
+void test_sample_path_does_not_allocate(void)
+{
+  for (uint8_t i = 0; i < 3; i++) samplePath();
+
+  AllocStats start = allocSnapshot();
+  for (uint16_t i = 0; i < ITERATIONS; i++) samplePath();
+  AllocStats end = allocSnapshot();
+
+  TEST_ASSERT_GREATER_THAN(10, validators.lastId());
+  TEST_ASSERT_EQUAL_UINT32(0, end.count - start.count);
+  TEST_ASSERT_EQUAL_UINT32(0, end.bytes - start.bytes);
+}
+
+void test_request_path_does_not_allocate(void)
+{
+  strcpy(etag, validators.etag());
+  requestPath();
+
+  responseBytes = 0;
+  AllocStats start = allocSnapshot();
+  for (uint16_t i = 0; i < ITERATIONS; i++) requestPath();
+  AllocStats end = allocSnapshot();
+
+  TEST_ASSERT_GREATER_THAN(0, responseBytes);
+  TEST_ASSERT_EQUAL_UINT32(0, end.count - start.count);
+  TEST_ASSERT_EQUAL_UINT32(0, end.bytes - start.bytes);
+}
+
+int main(int, char**)
+{
+  bus.attach(SENSOR_ADDRESS, &chip);
+  bus.setClock(400000);
+  sensor.init();
+  sensor.setChangeThreshold(40, 2);
+  display.begin(SSD1306_SWITCHCAPVCC, OLED_ADDRESS);
+  renderer.init();
+  validators.reset(1);
+  measurementLog.begin(File(&colors));
+  api.begin();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_counters_see_heap_allocations);
+  RUN_TEST(test_sample_path_does_not_allocate);
+  RUN_TEST(test_request_path_does_not_allocate);
+  return UNITY_END();
+}
@@ -0,0 +1,191 @@
+#include <unity.h>
+#include "CacheValidators.h"
+#include "MeasurementJson.h"
+
+#define ROWS 2000
+#define POLLS 200
+
+static CacheValidators validators;
+
+static const char* CORS_HEADERS =
+  "Access-Control-Allow-Origin: *\r\n"
+  "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+  "Access-Control-Allow-Headers: Content-Type, If-None-Match, If-Modified-Since\r\n"
+  "Access-Control-Expose-Headers: ETag, Last-Modified\r\n";
+
+static uint64_t nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static size_t validatorHeaderBytes()
+{
+  return strlen("Cache-Control: no-cache\r\nETag: \r\nLast-Modified: \r\n") +
+         strlen(validators.etag()) + strlen(validators.lastModified());
+}
+
+static size_t bodyLength;
+
+static void countChunk(void*, const char*, size_t length)
+{
+  bodyLength += length;
+}
+
+// Builds the 200 body with the handler's writer; returns its length.
+static size_t buildBody(const char* csv)
+{
+  MeasurementJsonWriter writer(countChunk, nullptr, 0);
+  char line[64];
+  bodyLength = 0;
+  writer.begin();
+  while (*csv) {
+    size_t length = strcspn(csv, "\n");
+    memcpy(line, csv, length);
+    line[length] = '\0';
+    csv += length + (csv[length] == '\n');
+    writer.addRow(line);
+  }
+  writer.end();
+  return bodyLength;
+}
+
+static char* makeCsv(uint32_t rows)
+{
+  char* csv = (char*)malloc(rows * 48 + 32);
+  size_t used = sprintf(csv, "ID,Red,Green,Blue,CreatedAt\n");
+  for (uint32_t id = 1; id <= rows; id++) {
+    used += formatMeasurementRow(csv + used, 64, id, 4000 + id % 97, 3000 + id % 89, 2000 + id % 83,
+                                 1760000000 + id * 5);
+  }
+  return csv;
+}
+
+void setUp(void)
+{
+  validators.reset(7);
+}
+
+void tearDown(void)
+{
+}
+
+void test_etag_combines_generation_and_last_id(void)
+{
+  TEST_ASSERT_EQUAL_STRING("W/\"7-0\"", validators.etag());
+  TEST_ASSERT_EQUAL_STRING("", validators.lastModified());
+  validators.recordWritten(42, 1760000000);
+  TEST_ASSERT_EQUAL_STRING("W/\"7-42\"", validators.etag());
+  TEST_ASSERT_EQUAL_STRING("Thu, 09 Oct 2025 08:53:20 GMT", validators.lastModified());
+  TEST_ASSERT_EQUAL(42, validators.lastId());
+}
+
+void test_reset_starts_a_new_generation(void)
+{
+  validators.recordWritten(42, 1760000000);
+  validators.reset(8);
+  TEST_ASSERT_EQUAL_STRING("W/\"8-0\"", validators.etag());
+  TEST_ASSERT_EQUAL_STRING("", validators.lastModified());
+  TEST_ASSERT_FALSE(validators.notModified("W/\"7-42\"", nullptr));
+}
+
+void test_if_none_match(void)
+{
+  validators.recordWritten(3, 1760000000);
+  TEST_ASSERT_TRUE(validators.notModified("W/\"7-3\"", ""));
+  TEST_ASSERT_FALSE(validators.notModified("W/\"7-2\"", ""));
+  TEST_ASSERT_FALSE(validators.notModified("", ""));
+  TEST_ASSERT_FALSE(validators.notModified(nullptr, nullptr));
+}
+
+void test_if_none_match_takes_precedence_over_if_modified_since(void)
+{
+  validators.recordWritten(3, 1760000000);
+  TEST_ASSERT_FALSE(validators.notModified("W/\"7-2\"", validators.lastModified()));
+}
+
+void test_if_modified_since(void)
+{
+  TEST_ASSERT_FALSE(validators.notModified("", ""));
+  validators.recordWritten(3, 1760000000);
+  TEST_ASSERT_TRUE(validators.notModified("", "Thu, 09 Oct 2025 08:53:20 GMT"));
+  TEST_ASSERT_FALSE(validators.notModified("", "Thu, 09 Oct 2025 08:53:15 GMT"));
+}
+
+void test_unsynced_clock_sends_no_last_modified(void)
+{
+  validators.recordWritten(1, 0);
+  TEST_ASSERT_EQUAL_STRING("", validators.lastModified());
+  TEST_ASSERT_FALSE(validators.notModified("", ""));
+
+  // time() counting from boot: the same 1970 date comes back after a reboot.
+  validators.recordWritten(2, 3600);
+  TEST_ASSERT_EQUAL_STRING("", validators.lastModified());
+  TEST_ASSERT_FALSE(validators.notModified("", "Thu, 01 Jan 1970 01:00:00 GMT"));
+}
+
+void test_if_modified_since_ignored_when_if_none_match_present(void)
+{
+  validators.recordWritten(3, 1760000000);
+  TEST_ASSERT_FALSE(validators.notModified("W/\"6-3\"", "Thu, 09 Oct 2025 08:53:20 GMT"));
+  TEST_ASSERT_TRUE(validators.notModified("W/\"7-3\"", "Mon, 01 Jan 2024 00:00:00 GMT"));
+}
+
+// One idle poll (nothing new was written) with and without validators.
+// Bytes are computed for the wire. The times are host times of the parts
+// this module replaces: building the JSON body versus the notModified()
+// compare. They are not the device's CPU cost per poll, which also covers
+// TCP, request parsing and sending headers in ESP8266WebServer.
+void test_idle_poll_bytes_and_host_time(void)
+{
+  char* csv = makeCsv(ROWS);
+  validators.recordWritten(ROWS, 1760000000 + ROWS * 5);
+
+  const char* request = "GET /api/measurements HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n";
+  size_t body = buildBody(csv);
+  size_t chunkFraming = (body / MeasurementJsonWriter::CHUNK_SIZE + 2) * 7;
+  size_t before = strlen(request) + strlen("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n") +
+                  strlen(CORS_HEADERS) + strlen("Transfer-Encoding: chunked\r\nConnection: close\r\n\r\n") +
+                  body + chunkFraming;
+  size_t after = strlen(request) + strlen("If-None-Match: \r\n") + strlen(validators.etag()) +
+                 strlen("HTTP/1.1 304 Not Modified\r\n") + strlen(CORS_HEADERS) + validatorHeaderBytes() +
+                 strlen("Content-Length: 0\r\nConnection: close\r\n\r\n");
+
+  uint64_t start = nowNs();
+  size_t sink = 0;
+  for (int i = 0; i < POLLS; i++) sink += buildBody(csv);
+  uint64_t beforeNs = (nowNs() - start) / POLLS;
+
+  char ifNoneMatch[32];
+  strcpy(ifNoneMatch, validators.etag());
+  start = nowNs();
+  for (int i = 0; i < POLLS * 1000; i++) sink += validators.notModified(ifNoneMatch, "");
+  uint64_t afterNs = (nowNs() - start) / (POLLS * 1000);
+
+  TEST_ASSERT_TRUE(validators.notModified(ifNoneMatch, ""));
+  TEST_ASSERT_LESS_THAN(before / 50, after);
+  TEST_ASSERT_TRUE(sink > 0);
+
+  char report[240];
+  snprintf(report, sizeof(report),
+           "idle poll with %u rows: %u bytes, %.1f us host time to build the body before; "
+           "%u bytes, %.3f us host time for notModified() with 304 (not device CPU)",
+           ROWS, (unsigned)before, beforeNs / 1000.0, (unsigned)after, afterNs / 1000.0);
+  TEST_MESSAGE(report);
+  free(csv);
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_etag_combines_generation_and_last_id);
+  RUN_TEST(test_reset_starts_a_new_generation);
+  RUN_TEST(test_if_none_match);
+  RUN_TEST(test_if_none_match_takes_precedence_over_if_modified_since);
+  RUN_TEST(test_if_modified_since);
+  RUN_TEST(test_unsynced_clock_sends_no_last_modified);
+  RUN_TEST(test_if_modified_since_ignored_when_if_none_match_present);
+  RUN_TEST(test_idle_poll_bytes_and_host_time);
+  return UNITY_END();
+}
@@ -0,0 +1,298 @@
+#include <unity.h>
+#include "ColorSensor.h"
+
+#define SENSOR_ADDRESS 0x29
+#define CYCLE_US 600000
+
+struct Reading
+{
+  uint16_t clear, red, green, blue;
+};
+
+// Register-level TCS34725: command byte decoding (repeated byte, auto
+// increment, special function), ENABLE/ATIME/PERS/threshold registers and an
+// integration cycle every (256 - ATIME) * 2.4 ms that latches the next
+// scripted reading and evaluates the clear-channel interrupt.
+class FakeTcs34725 : public FakeI2cDevice
+{
+public:
+  uint8_t regs[0x20];
+  const Reading* script = nullptr;
+  size_t scriptLength = 0;
+  uint32_t cycles = 0;
+
+  FakeTcs34725()
+  {
+    memset(regs, 0, sizeof(regs));
+    regs[TCS34725_ID] = 0x44;
+    regs[TCS34725_ATIME] = 0xFF;
+  }
+
+  void receive(const uint8_t* data, size_t length) override
+  {
+    advance();
+    if (length == 0 || !(data[0] & TCS34725_COMMAND_BIT)) return;
+    uint8_t type = data[0] & 0x60;
+    if (type == 0x60) {
+      if ((data[0] & 0x1F) == (TCS34725_CLEAR_INT & 0x1F)) regs[TCS34725_STATUS] &= ~TCS34725_STATUS_AINT;
+      return;
+    }
+    pointer = data[0] & 0x1F;
+    autoIncrement = type == TCS34725_AUTO_INCREMENT;
+    for (size_t i = 1; i < length; i++) {
+      writeRegister(pointer, data[i]);
+      if (autoIncrement) pointer++;
+    }
+  }
+
+  size_t transmit(uint8_t* data, size_t length) override
+  {
+    advance();
+    for (size_t i = 0; i < length; i++) {
+      data[i] = regs[(pointer + (autoIncrement ? i : 0)) & 0x1F];
+    }
+    return length;
+  }
+
+private:
+  uint8_t pointer = 0;
+  bool autoIncrement = false;
+  uint64_t cycleStart = 0;
+  uint8_t outOfRange = 0;
+
+  void writeRegister(uint8_t reg, uint8_t value)
+  {
+    if (reg == TCS34725_ENABLE && (value & TCS34725_ENABLE_AEN) && !(regs[reg] & TCS34725_ENABLE_AEN)) {
+      cycleStart = fakeNowUs;
+    }
+    if (reg < TCS34725_ID) regs[reg] = value;
+  }
+
+  uint64_t cycleUs() const
+  {
+    return (256 - regs[TCS34725_ATIME]) * 2400ULL;
+  }
+
+  uint8_t persistenceCycles() const
+  {
+    uint8_t apers = regs[TCS34725_PERS] & 0x0F;
+    return apers <= 3 ? apers : (apers - 3) * 5;
+  }
+
+  void advance()
+  {
+    if (!(regs[TCS34725_ENABLE] & TCS34725_ENABLE_AEN)) return;
+    while (fakeNowUs - cycleStart >= cycleUs()) {
+      cycleStart += cycleUs();
+      completeCycle();
+    }
+  }
+
+  void completeCycle()
+  {
+    Reading r = script[cycles < scriptLength ? cycles : scriptLength - 1];
+    cycles++;
+    const uint16_t values[] = {r.clear, r.red, r.green, r.blue};
+    for (uint8_t i = 0; i < 4; i++) {
+      regs[TCS34725_CDATAL + i * 2] = values[i] & 0xFF;
+      regs[TCS34725_CDATAL + i * 2 + 1] = values[i] >> 8;
+    }
+    regs[TCS34725_STATUS] |= TCS34725_STATUS_AVALID;
+
+    uint16_t low = regs[TCS34725_AILTL] | regs[TCS34725_AILTL + 1] << 8;
+    uint16_t high = regs[TCS34725_AILTL + 2] | regs[TCS34725_AILTL + 3] << 8;
+    if (r.clear < low || r.clear > high) {
+      outOfRange++;
+    } else {
+      outOfRange = 0;
+    }
+    if ((regs[TCS34725_ENABLE] & TCS34725_ENABLE_AIEN) && outOfRange > 0 && outOfRange >= persistenceCycles()) {
+      regs[TCS34725_STATUS] |= TCS34725_STATUS_AINT;
+      outOfRange = 0;
+    }
+  }
+};
+
+static TwoWire bus;
+static FakeTcs34725 chip;
+static ColorSensor* sensor;
+
+static const Reading steadyThenStep[] = {
+  {1000, 400, 300, 200}, {1003, 401, 299, 200}, {998, 399, 301, 201}, {1001, 400, 300, 199},
+  {1002, 402, 300, 200}, {2000, 900, 600, 400}, {2004, 901, 601, 400}, {2001, 900, 600, 401},
+};
+
+static void startSensor(const Reading* script, size_t length, uint8_t persistence)
+{
+  chip.script = script;
+  chip.scriptLength = length;
+  TEST_ASSERT_TRUE(sensor->init());
+  sensor->setChangeThreshold(40, persistence);
+  bus.resetStats();
+}
+
+// Moves the clock to the end of the next integration cycle and polls.
+static bool nextCycle(bool readAnyway = false)
+{
+  fakeNowUs += CYCLE_US + 1000;
+  return sensor->poll(millis(), readAnyway);
+}
+
+// The Adafruit_TCS34725::getRawData() path: four read16() transactions at
+// the default 100 kHz, then a blocking delay for the integration time.
+static void adafruitGetRawData(uint16_t values[4])
+{
+  bus.setClock(100000);
+  for (uint8_t i = 0; i < 4; i++) {
+    bus.beginTransmission(SENSOR_ADDRESS);
+    bus.write((uint8_t)(TCS34725_COMMAND_BIT | (TCS34725_CDATAL + i * 2)));
+    bus.endTransmission();
+    bus.requestFrom(SENSOR_ADDRESS, 2);
+    values[i] = bus.read();
+    values[i] |= bus.read() << 8;
+  }
+  delay((256 - TCS34725_ATIME_600MS) * 12 / 5 + 1);
+}
+
+void setUp(void)
+{
+  fakeNowUs = 0;
+  bus = TwoWire();
+  chip = FakeTcs34725();
+  bus.attach(SENSOR_ADDRESS, &chip);
+  bus.setClock(400000);
+  sensor = new ColorSensor(bus, SENSOR_ADDRESS, TCS34725_ATIME_600MS, TCS34725_GAIN_X1);
+}
+
+void tearDown(void)
+{
+  delete sensor;
+}
+
+void test_init_configures_integration_and_interrupt(void)
+{
+  startSensor(steadyThenStep, 8, 2);
+  TEST_ASSERT_EQUAL_HEX8(TCS34725_ATIME_600MS, chip.regs[TCS34725_ATIME]);
+  TEST_ASSERT_EQUAL_HEX8(TCS34725_GAIN_X1, chip.regs[TCS34725_CONTROL]);
+  TEST_ASSERT_EQUAL_HEX8(2, chip.regs[TCS34725_PERS]);
+  TEST_ASSERT_EQUAL_HEX8(TCS34725_ENABLE_PON | TCS34725_ENABLE_AEN | TCS34725_ENABLE_AIEN,
+                         chip.regs[TCS34725_ENABLE]);
+}
+
+void test_init_rejects_unknown_id(void)
+{
+  chip.regs[TCS34725_ID] = 0x00;
+  TEST_ASSERT_FALSE(sensor->init());
+}
+
+void test_poll_does_not_touch_the_bus_mid_cycle(void)
+{
+  startSensor(steadyThenStep, 8, 0);
+  fakeNowUs += CYCLE_US / 2;
+  TEST_ASSERT_FALSE(sensor->poll(millis()));
+  TEST_ASSERT_EQUAL(0, bus.transactions);
+}
+
+void test_first_reading_trips_the_threshold_and_reads_one_burst(void)
+{
+  startSensor(steadyThenStep, 8, 0);
+  TEST_ASSERT_TRUE(nextCycle());
+  TEST_ASSERT_TRUE(sensor->changed());
+  TEST_ASSERT_EQUAL(1000, sensor->clear());
+  TEST_ASSERT_EQUAL(400, sensor->red());
+  TEST_ASSERT_EQUAL(300, sensor->green());
+  TEST_ASSERT_EQUAL(200, sensor->blue());
+  // STATUS (write + read), burst (write + read), re-arm, clear interrupt.
+  TEST_ASSERT_EQUAL(6, bus.transactions);
+  TEST_ASSERT_EQUAL(960, chip.regs[TCS34725_AILTL] | chip.regs[TCS34725_AILTL + 1] << 8);
+  TEST_ASSERT_EQUAL(1040, chip.regs[TCS34725_AILTL + 2] | chip.regs[TCS34725_AILTL + 3] << 8);
+}
+
+void test_steady_scene_costs_one_status_read_per_cycle(void)
+{
+  startSensor(steadyThenStep, 8, 0);
+  TEST_ASSERT_TRUE(nextCycle());
+  bus.resetStats();
+
+  for (uint8_t i = 0; i < 4; i++) {
+    TEST_ASSERT_FALSE(nextCycle());
+    TEST_ASSERT_FALSE(sensor->changed());
+  }
+  TEST_ASSERT_EQUAL(4 * 2, bus.transactions);
+  TEST_ASSERT_EQUAL(1000, sensor->clear());
+
+  TEST_ASSERT_TRUE(nextCycle());
+  TEST_ASSERT_TRUE(sensor->changed());
+  TEST_ASSERT_EQUAL(2000, sensor->clear());
+  TEST_ASSERT_EQUAL(900, sensor->red());
+}
+
+void test_read_anyway_fetches_without_a_change(void)
+{
+  startSensor(steadyThenStep, 8, 0);
+  TEST_ASSERT_TRUE(nextCycle());
+  TEST_ASSERT_TRUE(nextCycle(true));
+  TEST_ASSERT_FALSE(sensor->changed());
+  TEST_ASSERT_EQUAL(1003, sensor->clear());
+  TEST_ASSERT_EQUAL(401, sensor->red());
+}
+
+void test_persistence_ignores_a_one_cycle_blip(void)
+{
+  static const Reading blip[] = {
+    {1000, 400, 300, 200}, {1000, 400, 300, 200}, {3000, 900, 900, 900}, {1000, 400, 300, 200},
+    {1000, 400, 300, 200}, {3000, 900, 900, 900}, {3000, 900, 900, 900}, {3000, 900, 900, 900},
+  };
+  startSensor(blip, 8, 2);
+  TEST_ASSERT_FALSE(nextCycle());
+  TEST_ASSERT_TRUE(nextCycle());
+  TEST_ASSERT_EQUAL(1000, sensor->clear());
+
+  TEST_ASSERT_FALSE(nextCycle());
+  TEST_ASSERT_FALSE(nextCycle());
+  TEST_ASSERT_FALSE(nextCycle());
+  TEST_ASSERT_FALSE(nextCycle());
+  TEST_ASSERT_TRUE(nextCycle());
+  TEST_ASSERT_EQUAL(3000, sensor->clear());
+}
+
+void test_bus_time_per_reading_against_adafruit_path(void)
+{
+  startSensor(steadyThenStep, 8, 0);
+  TEST_ASSERT_TRUE(nextCycle());
+  bus.resetStats();
+
+  TEST_ASSERT_TRUE(nextCycle(true));
+  uint64_t burstNs = bus.busyNs;
+  TEST_ASSERT_EQUAL(4, bus.transactions);
+
+  bus.resetStats();
+  uint32_t before = millis();
+  uint16_t values[4];
+  adafruitGetRawData(values);
+  uint64_t adafruitNs = bus.busyNs;
+  uint32_t blockedMs = millis() - before;
+  TEST_ASSERT_EQUAL(8, bus.transactions);
+  TEST_ASSERT_LESS_THAN(adafruitNs / 4, burstNs);
+
+  char report[160];
+  snprintf(report, sizeof(report),
+           "bus time per reading: %.0f us (STATUS + burst, 400 kHz) vs %.0f us (getRawData, 100 kHz), "
+           "which also blocks loop() for %u ms",
+           burstNs / 1000.0, adafruitNs / 1000.0, (unsigned)blockedMs);
+  TEST_MESSAGE(report);
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_init_configures_integration_and_interrupt);
+  RUN_TEST(test_init_rejects_unknown_id);
+  RUN_TEST(test_poll_does_not_touch_the_bus_mid_cycle);
+  RUN_TEST(test_first_reading_trips_the_threshold_and_reads_one_burst);
+  RUN_TEST(test_steady_scene_costs_one_status_read_per_cycle);
+  RUN_TEST(test_read_anyway_fetches_without_a_change);
+  RUN_TEST(test_persistence_ignores_a_one_cycle_blip);
+  RUN_TEST(test_bus_time_per_reading_against_adafruit_path);
+  return UNITY_END();
+}
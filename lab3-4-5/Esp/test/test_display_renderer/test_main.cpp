@@ -0,0 +1,262 @@
+#include <unity.h>
+#include "DisplayRenderer.h"
+
+#define OLED_ADDRESS 0x3C
+#define I2C_CLOCK 400000
+#define MAX_FPS 4
+
+// SSD1306 in horizontal addressing mode: keeps its own GDDRAM so a test can
+// check that what reached the panel matches the frame buffer.
+class FakePanel : public FakeI2cDevice
+{
+public:
+  uint8_t ram[8][128];
+
+  FakePanel()
+  {
+    memset(ram, 0, sizeof(ram));
+  }
+
+  void receive(const uint8_t* data, size_t length) override
+  {
+    if (length == 0) return;
+    if (data[0] == 0x40) {
+      for (size_t i = 1; i < length; i++) writeData(data[i]);
+      return;
+    }
+    for (size_t i = 1; i < length; i++) command(data[i]);
+  }
+
+  size_t transmit(uint8_t*, size_t) override
+  {
+    return 0;
+  }
+
+private:
+  uint8_t pending = 0;
+  uint8_t args[2];
+  uint8_t argCount = 0;
+  uint8_t pageStart = 0, pageEnd = 7, columnStart = 0, columnEnd = 127;
+  uint8_t page = 0, column = 0;
+
+  void command(uint8_t value)
+  {
+    if (pending == 0) {
+      if (value == SSD1306_PAGEADDR || value == SSD1306_COLUMNADDR) {
+        pending = value;
+        argCount = 0;
+      }
+      return;
+    }
+    args[argCount++] = value;
+    if (argCount < 2) return;
+    if (pending == SSD1306_PAGEADDR) {
+      pageStart = page = args[0] & 7;
+      pageEnd = args[1] & 7;
+    } else {
+      columnStart = column = args[0] & 127;
+      columnEnd = args[1] & 127;
+    }
+    pending = 0;
+  }
+
+  void writeData(uint8_t value)
+  {
+    ram[page][column] = value;
+    if (column++ == columnEnd) {
+      column = columnStart;
+      page = page == pageEnd ? pageStart : page + 1;
+    }
+  }
+};
+
+static TwoWire bus;
+static FakePanel panel;
+static Adafruit_SSD1306* display;
+static DisplayRenderer* renderer;
+
+// Stands in for Adafruit_GFX text at size 1: a 6x8 cell per character, so
+// each text line sits on one page. Glyph columns only need to differ per
+// character.
+static void drawText(uint8_t line, const char* text)
+{
+  uint8_t* page = display->getBuffer() + line * 128;
+  memset(page, 0, 128);
+  for (uint8_t i = 0; text[i] && i < 21; i++) {
+    for (uint8_t x = 0; x < 5; x++) {
+      page[i * 6 + x] = (uint8_t)(text[i] * 37 + x * 11) | 0x01;
+    }
+  }
+}
+
+static void drawReading(uint16_t r, uint16_t g, uint16_t b)
+{
+  char line[22];
+  snprintf(line, sizeof(line), "R:%u", r);
+  drawText(0, line);
+  snprintf(line, sizeof(line), "G:%u", g);
+  drawText(1, line);
+  snprintf(line, sizeof(line), "B:%u", b);
+  drawText(2, line);
+}
+
+// Services the renderer until the frame is out; returns the number of
+// service() calls that touched the bus and the largest bus time of one call.
+static uint8_t finishFrame(uint32_t now, uint64_t& worstCallNs)
+{
+  uint8_t calls = 0;
+  worstCallNs = 0;
+  do {
+    uint64_t before = bus.busyNs;
+    renderer->service(now);
+    uint64_t spent = bus.busyNs - before;
+    if (spent > 0) calls++;
+    if (spent > worstCallNs) worstCallNs = spent;
+  } while (renderer->isBusy());
+  return calls;
+}
+
+static void assertPanelMatchesBuffer()
+{
+  TEST_ASSERT_EQUAL_MEMORY(display->getBuffer(), panel.ram, sizeof(panel.ram));
+}
+
+// Bytes and bus time of the old path: clearDisplay(), printf(), display().
+static void measureFullRedraw(uint32_t& bytes, uint64_t& busyNs)
+{
+  bus.resetStats();
+  display->display();
+  bytes = bus.payloadBytes;
+  busyNs = bus.busyNs;
+  bus.resetStats();
+}
+
+void setUp(void)
+{
+  bus = TwoWire();
+  panel = FakePanel();
+  bus.attach(OLED_ADDRESS, &panel);
+  bus.setClock(I2C_CLOCK);
+  display = new Adafruit_SSD1306(128, 64, &bus, -1, I2C_CLOCK, I2C_CLOCK);
+  display->begin(SSD1306_SWITCHCAPVCC, OLED_ADDRESS);
+  renderer = new DisplayRenderer(*display, bus, OLED_ADDRESS, MAX_FPS);
+
+  drawReading(1234, 2345, 3456);
+  renderer->init();
+  bus.resetStats();
+}
+
+void tearDown(void)
+{
+  delete renderer;
+  delete display;
+}
+
+void test_init_pushes_the_whole_frame(void)
+{
+  assertPanelMatchesBuffer();
+}
+
+void test_unchanged_frame_costs_no_bus_traffic(void)
+{
+  drawReading(1234, 2345, 3456);
+  renderer->requestFrame();
+  uint64_t worst;
+  TEST_ASSERT_EQUAL(0, finishFrame(1000, worst));
+  TEST_ASSERT_EQUAL(0, bus.transactions);
+  TEST_ASSERT_EQUAL(0, renderer->bytesSent());
+}
+
+void test_one_changed_digit_sends_one_span(void)
+{
+  uint32_t fullBytes;
+  uint64_t fullNs;
+  measureFullRedraw(fullBytes, fullNs);
+
+  drawReading(1235, 2345, 3456);
+  renderer->requestFrame();
+  uint64_t worst;
+  TEST_ASSERT_EQUAL(1, finishFrame(1000, worst));
+  assertPanelMatchesBuffer();
+
+  // Six addressing commands plus one data transaction for the glyph.
+  TEST_ASSERT_EQUAL(7, bus.transactions);
+  TEST_ASSERT_EQUAL(bus.payloadBytes, renderer->bytesSent());
+  TEST_ASSERT_LESS_THAN(fullBytes / 20, bus.payloadBytes);
+  TEST_ASSERT_LESS_THAN(fullNs / 10, bus.busyNs);
+
+  char report[160];
+  snprintf(report, sizeof(report),
+           "one digit: %u bytes, %.0f us bus time; full redraw: %u bytes, %.0f us",
+           (unsigned)bus.payloadBytes, bus.busyNs / 1000.0, (unsigned)fullBytes, fullNs / 1000.0);
+  TEST_MESSAGE(report);
+}
+
+void test_new_reading_updates_three_pages_one_per_call(void)
+{
+  uint32_t fullBytes;
+  uint64_t fullNs;
+  measureFullRedraw(fullBytes, fullNs);
+
+  drawReading(987, 65535, 12);
+  renderer->requestFrame();
+  uint64_t worst;
+  TEST_ASSERT_EQUAL(3, finishFrame(1000, worst));
+  assertPanelMatchesBuffer();
+  TEST_ASSERT_EQUAL(bus.payloadBytes, renderer->bytesSent());
+  TEST_ASSERT_LESS_THAN(fullBytes / 4, bus.payloadBytes);
+  // No single loop() pass holds the bus for more than a page.
+  TEST_ASSERT_LESS_THAN(fullNs / 8, worst);
+
+  char report[160];
+  snprintf(report, sizeof(report),
+           "new reading: %u bytes, %.0f us bus time, longest pass %.0f us; full redraw: %u bytes, %.0f us in one pass",
+           (unsigned)bus.payloadBytes, bus.busyNs / 1000.0, worst / 1000.0, (unsigned)fullBytes, fullNs / 1000.0);
+  TEST_MESSAGE(report);
+}
+
+void test_frames_are_rate_limited(void)
+{
+  uint64_t worst;
+  drawReading(1, 2, 3);
+  renderer->requestFrame();
+  finishFrame(1000, worst);
+  bus.resetStats();
+
+  drawReading(4, 5, 6);
+  renderer->requestFrame();
+  TEST_ASSERT_FALSE(renderer->service(1000 + 1000 / MAX_FPS - 1));
+  TEST_ASSERT_EQUAL(0, bus.transactions);
+
+  TEST_ASSERT_EQUAL(3, finishFrame(1000 + 1000 / MAX_FPS, worst));
+  assertPanelMatchesBuffer();
+}
+
+void test_requests_during_a_frame_are_coalesced(void)
+{
+  drawReading(1, 2, 3);
+  renderer->requestFrame();
+  renderer->service(1000);
+  TEST_ASSERT_TRUE(renderer->isBusy());
+
+  // Redrawn while the frame is going out: the rest of this frame already
+  // picks up the change, the next request just sends what is still stale.
+  drawReading(7, 8, 9);
+  renderer->requestFrame();
+  uint64_t worst;
+  finishFrame(1000, worst);
+  finishFrame(1000 + 1000 / MAX_FPS, worst);
+  assertPanelMatchesBuffer();
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_init_pushes_the_whole_frame);
+  RUN_TEST(test_unchanged_frame_costs_no_bus_traffic);
+  RUN_TEST(test_one_changed_digit_sends_one_span);
+  RUN_TEST(test_new_reading_updates_three_pages_one_per_call);
+  RUN_TEST(test_frames_are_rate_limited);
+  RUN_TEST(test_requests_during_a_frame_are_coalesced);
+  return UNITY_END();
+}
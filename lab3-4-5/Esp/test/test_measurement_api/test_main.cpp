@@ -0,0 +1,128 @@
+#include <unity.h>
+#include "MeasurementApi.h"
+#include "HttpStatus.h"
+
+static FakeFileData colors;
+static ESP8266WebServer server;
+static CacheValidators validators;
+static MeasurementLog measurementLog(validators);
+static MeasurementApi api(server, measurementLog, validators);
+
+static void appendSample(uint16_t red, time_t createdAt)
+{
+  ColorSample sample = {0, createdAt, red, 200, 300};
+  TEST_ASSERT_GREATER_THAN(0, measurementLog.append(sample));
+}
+
+static void get(const char* since = nullptr)
+{
+  server.beginRequest(HTTP_GET, "/api/measurements");
+  if (since) server.addArg("since", since);
+}
+
+void setUp(void)
+{
+  colors.size = 0;
+  const char* header = "ID,Red,Green,Blue,CreatedAt\n";
+  File file(&colors);
+  file.write((const uint8_t*)header, strlen(header));
+  validators.reset(4);
+  measurementLog.begin(file);
+}
+
+void tearDown(void)
+{
+}
+
+void test_append_writes_rows_and_updates_validators(void)
+{
+  appendSample(100, 1760000000);
+  appendSample(110, 1760000005);
+  TEST_ASSERT_EQUAL_STRING("2,110,200,300,2025-10-09T08:53:25.000Z\n", measurementLog.lastRow());
+  TEST_ASSERT_EQUAL_STRING("W/\"4-2\"", validators.etag());
+  TEST_ASSERT_EQUAL(28 + 2 * 39, colors.size);
+}
+
+void test_full_list_with_validators(void)
+{
+  appendSample(100, 1760000000);
+  appendSample(110, 1760000005);
+  get();
+  api.handle();
+  TEST_ASSERT_EQUAL(HTTP_OK, server.status);
+  TEST_ASSERT_EQUAL_STRING("W/\"4-2\"", server.sentHeader("ETag"));
+  TEST_ASSERT_EQUAL_STRING("Thu, 09 Oct 2025 08:53:25 GMT", server.sentHeader("Last-Modified"));
+  TEST_ASSERT_EQUAL_STRING("[{\"id\":1,\"red\":100,\"green\":200,\"blue\":300,\"createdAt\":\"2025-10-09T08:53:20.000Z\"},"
+                           "{\"id\":2,\"red\":110,\"green\":200,\"blue\":300,\"createdAt\":\"2025-10-09T08:53:25.000Z\"}]",
+                           server.body);
+}
+
+void test_since_returns_newer_rows_only(void)
+{
+  for (uint16_t i = 0; i < 5; i++) appendSample(100 + i, 1760000000 + i);
+  get("3");
+  api.handle();
+  TEST_ASSERT_EQUAL(HTTP_OK, server.status);
+  TEST_ASSERT_NULL(strstr(server.body, "\"id\":3,"));
+  TEST_ASSERT_NOT_NULL(strstr(server.body, "[{\"id\":4,"));
+  TEST_ASSERT_NOT_NULL(strstr(server.body, "{\"id\":5,"));
+}
+
+void test_if_none_match_answers_304_past_the_core_header_keys(void)
+{
+  appendSample(100, 1760000000);
+  get();
+  server.setHeader("If-None-Match", "W/\"4-1\"");
+  api.handle();
+  TEST_ASSERT_EQUAL(HTTP_NOT_MODIFIED, server.status);
+  TEST_ASSERT_EQUAL(0, server.bodyBytes);
+
+  appendSample(110, 1760000005);
+  get();
+  server.setHeader("If-None-Match", "W/\"4-1\"");
+  api.handle();
+  TEST_ASSERT_EQUAL(HTTP_OK, server.status);
+}
+
+void test_if_modified_since_alone(void)
+{
+  appendSample(100, 1760000000);
+  get();
+  server.setHeader("If-Modified-Since", "Thu, 09 Oct 2025 08:53:20 GMT");
+  api.handle();
+  TEST_ASSERT_EQUAL(HTTP_NOT_MODIFIED, server.status);
+}
+
+void test_appends_after_a_read_go_to_the_end(void)
+{
+  appendSample(100, 1760000000);
+  get();
+  api.handle();
+  appendSample(110, 1760000005);
+  get("1");
+  api.handle();
+  TEST_ASSERT_NOT_NULL(strstr(server.body, "[{\"id\":2,\"red\":110,"));
+  TEST_ASSERT_EQUAL(0, memcmp(colors.bytes, "ID,Red", 6));
+}
+
+void test_missing_log_is_404(void)
+{
+  measurementLog.begin(File());
+  get();
+  api.handle();
+  TEST_ASSERT_EQUAL(HTTP_NOT_FOUND, server.status);
+}
+
+int main(int, char**)
+{
+  api.begin();
+  UNITY_BEGIN();
+  RUN_TEST(test_append_writes_rows_and_updates_validators);
+  RUN_TEST(test_full_list_with_validators);
+  RUN_TEST(test_since_returns_newer_rows_only);
+  RUN_TEST(test_if_none_match_answers_304_past_the_core_header_keys);
+  RUN_TEST(test_if_modified_since_alone);
+  RUN_TEST(test_appends_after_a_read_go_to_the_end);
+  RUN_TEST(test_missing_log_is_404);
+  return UNITY_END();
+}
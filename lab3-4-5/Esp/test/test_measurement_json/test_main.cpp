@@ -0,0 +1,140 @@
+#include <unity.h>
+#include "MeasurementJson.h"
+
+static char response[64 * 1024];
+static size_t responseLength;
+static size_t chunks;
+static size_t largestChunk;
+
+static void collect(void*, const char* data, size_t length)
+{
+  memcpy(response + responseLength, data, length);
+  responseLength += length;
+  response[responseLength] = '\0';
+  chunks++;
+  if (length > largestChunk) largestChunk = length;
+}
+
+static void writeRows(MeasurementJsonWriter& writer, const char* csv)
+{
+  char line[64];
+  writer.begin();
+  while (*csv) {
+    size_t length = strcspn(csv, "\n");
+    memcpy(line, csv, length);
+    line[length] = '\0';
+    csv += length + (csv[length] == '\n');
+    writer.addRow(line);
+  }
+  writer.end();
+}
+
+void setUp(void)
+{
+  responseLength = 0;
+  chunks = 0;
+  largestChunk = 0;
+  response[0] = '\0';
+}
+
+void tearDown(void)
+{
+}
+
+void test_formats_a_storage_row(void)
+{
+  char line[64];
+  size_t length = formatMeasurementRow(line, sizeof(line), 12, 4000, 300, 65535, 1760000000);
+  TEST_ASSERT_EQUAL_STRING("12,4000,300,65535,2025-10-09T08:53:20.000Z\n", line);
+  TEST_ASSERT_EQUAL(strlen(line), length);
+  TEST_ASSERT_EQUAL(0, formatMeasurementRow(line, 20, 12, 4000, 300, 65535, 1760000000));
+}
+
+void test_empty_file_is_an_empty_array(void)
+{
+  MeasurementJsonWriter writer(collect, nullptr, 0);
+  writeRows(writer, "ID,Red,Green,Blue,CreatedAt\n");
+  TEST_ASSERT_EQUAL_STRING("[]", response);
+}
+
+void test_rows_become_objects(void)
+{
+  MeasurementJsonWriter writer(collect, nullptr, 0);
+  writeRows(writer,
+            "ID,Red,Green,Blue,CreatedAt\r\n"
+            "1,10,20,30,2025-10-09T08:53:20.000Z\r\n"
+            "\n"
+            "broken,row\n"
+            "2,11,21,31,2025-10-09T08:53:25.000Z \n");
+  TEST_ASSERT_EQUAL_STRING(
+    "[{\"id\":1,\"red\":10,\"green\":20,\"blue\":30,\"createdAt\":\"2025-10-09T08:53:20.000Z\"},"
+    "{\"id\":2,\"red\":11,\"green\":21,\"blue\":31,\"createdAt\":\"2025-10-09T08:53:25.000Z\"}]",
+    response);
+}
+
+void test_since_skips_older_rows(void)
+{
+  MeasurementJsonWriter writer(collect, nullptr, 2);
+  writeRows(writer,
+            "1,10,20,30,a\n"
+            "2,11,21,31,b\n"
+            "3,12,22,32,c\n");
+  TEST_ASSERT_EQUAL_STRING("[{\"id\":3,\"red\":12,\"green\":22,\"blue\":32,\"createdAt\":\"c\"}]", response);
+}
+
+// "[" plus eight 63-byte objects and their commas fill the buffer exactly,
+// leaving no room for the closing bracket.
+void test_buffer_filled_exactly_before_closing_bracket(void)
+{
+  static char csv[1024];
+  size_t csvLength = 0;
+  for (uint32_t id = 1; id <= 8; id++) {
+    csvLength += sprintf(csv + csvLength, "%u,1,1,1,0123456789abc\n", (unsigned)id);
+  }
+
+  MeasurementJsonWriter writer(collect, nullptr, 0);
+  writeRows(writer, csv);
+  TEST_ASSERT_EQUAL(MeasurementJsonWriter::CHUNK_SIZE + 1, responseLength);
+  TEST_ASSERT_EQUAL(2, chunks);
+  TEST_ASSERT_EQUAL(MeasurementJsonWriter::CHUNK_SIZE, largestChunk);
+  TEST_ASSERT_EQUAL(']', response[responseLength - 1]);
+}
+
+// Every row count from 0 to 200 with rows of varying width, so the chunk
+// buffer is left at many different fill levels.
+void test_chunks_never_exceed_the_buffer(void)
+{
+  static char csv[16 * 1024];
+  static char expected[64 * 1024];
+
+  for (uint32_t rows = 0; rows <= 200; rows++) {
+    size_t csvLength = 0;
+    size_t expectedLength = sprintf(expected, "[");
+    for (uint32_t id = 1; id <= rows; id++) {
+      unsigned red = id * 7919 % 65536;
+      csvLength += sprintf(csv + csvLength, "%u,%u,%u,%u,t%u\n", (unsigned)id, red, id % 10, 0u, (unsigned)(id % 1000));
+      expectedLength += sprintf(expected + expectedLength,
+                                "%s{\"id\":%u,\"red\":%u,\"green\":%u,\"blue\":0,\"createdAt\":\"t%u\"}",
+                                id == 1 ? "" : ",", (unsigned)id, red, (unsigned)(id % 10), (unsigned)(id % 1000));
+    }
+    sprintf(expected + expectedLength, "]");
+
+    setUp();
+    MeasurementJsonWriter writer(collect, nullptr, 0);
+    writeRows(writer, csv);
+    TEST_ASSERT_EQUAL_STRING(expected, response);
+    TEST_ASSERT_LESS_OR_EQUAL(MeasurementJsonWriter::CHUNK_SIZE, largestChunk);
+  }
+}
+
+int main(int, char**)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_formats_a_storage_row);
+  RUN_TEST(test_empty_file_is_an_empty_array);
+  RUN_TEST(test_rows_become_objects);
+  RUN_TEST(test_since_skips_older_rows);
+  RUN_TEST(test_buffer_filled_exactly_before_closing_bracket);
+  RUN_TEST(test_chunks_never_exceed_the_buffer);
+  return UNITY_END();
+}
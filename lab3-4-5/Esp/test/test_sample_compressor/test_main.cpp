@@ -0,0 +1,233 @@
+#include <unity.h>
+#include <stdlib.h>
+#include "SampleCompressor.h"
+
+#define TRACE_LENGTH 2880
+#define SAMPLE_MS 5000
+#define MAX_RECORDED 50000
+
+// A sensor trace recorded with the d1_mini_trace env: its serial log, of
+// which only the "@E,<ms>,S,<red << 16 | green>,<blue << 16 | clear>" lines
+// are read. SENSOR_TRACE overrides the path. No recording ships with the
+// repo, so the recorded-trace test is ignored until one is added.
+#define DEFAULT_SENSOR_TRACE "test/traces/sensor.log"
+
+// The configuration main.cpp ships with, and the swinging-door variant.
+static const CompressionConfig SHIPPED = {40, 0.02f, 2.3f, false, 300000, 65535};
+static const CompressionConfig SWINGING_DOOR = {40, 0.0f, 0.0f, true, 300000, 65535};
+
+static ColorSample synthetic[TRACE_LENGTH];
+static ColorSample recorded[MAX_RECORDED];
+static size_t recordedCount;
+static ColorSample kept[MAX_RECORDED + 1];
+static size_t keptCount;
+
+// Four hours of synthetic readings at the 5 s cadence: a surface under a
+// warming lamp (slow drift plus sensor noise), objects swapped in and out
+// (steps), a dimmer ramp and a dark period. Deterministic, so results
+// repeat. It checks the published bound; it is not a field measurement.
+static void buildSyntheticTrace()
+{
+  ColorSample* trace = synthetic;
+  uint32_t seed = 12345;
+  auto noise = [&seed](int amplitude) {
+    seed = seed * 1103515245 + 12345;
+    return (int)((seed >> 16) % (2 * amplitude + 1)) - amplitude;
+  };
+
+  for (size_t i = 0; i < TRACE_LENGTH; i++) {
+    float r, g, b;
+    if (i < 720) {
+      r = 4200 + i * 0.5f; g = 3900 + i * 0.4f; b = 2600 + i * 0.2f;
+    } else if (i < 1200) {
+      bool swapped = (i / 60) % 2;
+      r = swapped ? 9100 : 4560; g = swapped ? 2100 : 4188; b = swapped ? 1800 : 2744;
+    } else if (i < 1800) {
+      float level = (i - 1200) / 600.0f;
+      r = 1000 + 20000 * level; g = 900 + 17000 * level; b = 700 + 9000 * level;
+    } else if (i < 2300) {
+      r = 40; g = 35; b = 30;
+    } else {
+      r = 12000; g = 11000; b = 8000;
+    }
+    int amplitude = r < 100 ? 2 : 12;
+    trace[i].at = i * SAMPLE_MS;
+    trace[i].createdAt = 1760000000 + i * SAMPLE_MS / 1000;
+    trace[i].red = (uint16_t)(r + noise(amplitude));
+    trace[i].green = (uint16_t)(g + noise(amplitude));
+    trace[i].blue = (uint16_t)(b + noise(amplitude));
+  }
+}
+
+static size_t loadRecordedTrace(const char* path)
+{
+  FILE* file = fopen(path, "r");
+  if (!file) return 0;
+  char line[160];
+  size_t count = 0;
+  while (count < MAX_RECORDED && fgets(line, sizeof(line), file)) {
+    const char* record = strstr(line, "@E,");
+    unsigned long at, a, b;
+    char kind;
+    if (!record || sscanf(record, "@E,%lu,%c,%lu,%lu", &at, &kind, &a, &b) != 4 || kind != 'S') continue;
+    recorded[count++] = {(uint32_t)at, 0, (uint16_t)(a >> 16), (uint16_t)a, (uint16_t)(b >> 16)};
+  }
+  fclose(file);
+  return count;
+}
+
+static void compress(SampleCompressor& compressor, const ColorSample* trace, size_t length)
+{
+  keptCount = 0;
+  for (size_t i = 0; i < length; i++) {
+    if (compressor.push(trace[i], kept[keptCount])) keptCount++;
+  }
+  if (compressor.flush(kept[keptCount])) keptCount++;
+}
+
+static uint16_t channel(const ColorSample& sample, uint8_t index)
+{
+  return index == 0 ? sample.red : index == 1 ? sample.green : sample.blue;
+}
+
+// What a reader rebuilds at `at` from the kept points.
+static float reconstruct(uint32_t at, uint8_t index, bool linear)
+{
+  size_t next = 0;
+  while (next < keptCount && kept[next].at <= at) next++;
+  const ColorSample& before = kept[next - 1];
+  if (!linear || next == keptCount || before.at == at) {
+    return channel(before, index);
+  }
+  const ColorSample& after = kept[next];
+  float t = (float)(at - before.at) / (after.at - before.at);
+  return channel(before, index) + t * ((float)channel(after, index) - channel(before, index));
+}
+
+// Checks every reading against the published bound; returns the largest
+// error seen.
+static float checkReconstruction(const SampleCompressor& compressor, const ColorSample* trace, size_t length)
+{
+  ErrorBound bound = compressor.errorBound();
+  bool linear = compressor.config().swingingDoor;
+  TEST_ASSERT_TRUE(bound.bounded);
+  float worst = 0;
+  for (size_t i = 0; i < length; i++) {
+    for (uint8_t c = 0; c < 3; c++) {
+      float rebuilt = reconstruct(trace[i].at, c, linear);
+      float error = fabsf(rebuilt - channel(trace[i], c));
+      TEST_ASSERT_TRUE(error <= bound.absolute + bound.relative * rebuilt);
+      if (error > worst) worst = error;
+    }
+  }
+  return worst;
+}
+
+static void report(const char* name, const SampleCompressor& compressor, size_t length, float worst)
+{
+  ErrorBound bound = compressor.errorBound();
+  char text[200];
+  snprintf(text, sizeof(text), "%s: kept %u of %u (%.1f:1), max error %.1f counts, bound %.1f + %.2f * value",
+           name, (unsigned)keptCount, (unsigned)length, (float)length / keptCount, worst,
+           bound.absolute, bound.relative);
+  TEST_MESSAGE(text);
+}
+
+static void assertSilenceLimit(uint32_t maxSilenceMs)
+{
+  TEST_ASSERT_EQUAL(0, kept[0].at);
+  for (size_t i = 1; i < keptCount; i++) {
+    TEST_ASSERT_LESS_OR_EQUAL(maxSilenceMs, kept[i].at - kept[i - 1].at);
+  }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_recorded_trace(void)
+{
+  const char* path = getenv("SENSOR_TRACE") ? getenv("SENSOR_TRACE") : DEFAULT_SENSOR_TRACE;
+  if (recordedCount == 0) {
+    char text[160];
+    snprintf(text, sizeof(text), "no recorded sensor trace at %s", path);
+    TEST_IGNORE_MESSAGE(text);
+  }
+
+  const CompressionConfig* configs[] = {&SHIPPED, &SWINGING_DOOR};
+  const char* names[] = {"recorded, hold, shipped config", "recorded, swinging door"};
+  for (uint8_t i = 0; i < 2; i++) {
+    SampleCompressor compressor(*configs[i]);
+    compress(compressor, recorded, recordedCount);
+    float worst = checkReconstruction(compressor, recorded, recordedCount);
+    report(names[i], compressor, recordedCount, worst);
+  }
+}
+
+void test_shipped_config_on_synthetic_trace(void)
+{
+  SampleCompressor compressor(SHIPPED);
+  compress(compressor, synthetic, TRACE_LENGTH);
+  float worst = checkReconstruction(compressor, synthetic, TRACE_LENGTH);
+  assertSilenceLimit(SHIPPED.maxSilenceMs);
+  TEST_ASSERT_GREATER_THAN(10 * keptCount, TRACE_LENGTH);
+  report("synthetic, hold, shipped config", compressor, TRACE_LENGTH, worst);
+}
+
+void test_swinging_door_on_synthetic_trace(void)
+{
+  SampleCompressor compressor(SWINGING_DOOR);
+  compress(compressor, synthetic, TRACE_LENGTH);
+  float worst = checkReconstruction(compressor, synthetic, TRACE_LENGTH);
+  assertSilenceLimit(SWINGING_DOOR.maxSilenceMs);
+  TEST_ASSERT_GREATER_THAN(10 * keptCount, TRACE_LENGTH);
+  report("synthetic, swinging door", compressor, TRACE_LENGTH, worst);
+}
+
+void test_disabled_compression_keeps_everything(void)
+{
+  CompressionConfig config = {0, 0.0f, 0.0f, false, 0, 65535};
+  SampleCompressor compressor(config);
+  compress(compressor, synthetic, TRACE_LENGTH);
+  TEST_ASSERT_EQUAL(TRACE_LENGTH, keptCount);
+  TEST_ASSERT_EQUAL(0, checkReconstruction(compressor, synthetic, TRACE_LENGTH));
+}
+
+void test_delta_e_only_has_no_per_channel_bound(void)
+{
+  CompressionConfig config = {0, 0.0f, 2.3f, false, 300000, 65535};
+  SampleCompressor compressor(config);
+  compress(compressor, synthetic, TRACE_LENGTH);
+  TEST_ASSERT_LESS_THAN(TRACE_LENGTH, keptCount);
+  TEST_ASSERT_FALSE(compressor.errorBound().bounded);
+}
+
+void test_delta_e_keeps_a_perceptible_change_inside_the_deadband(void)
+{
+  CompressionConfig config = {400, 0.0f, 2.3f, false, 0, 65535};
+  SampleCompressor compressor(config);
+  ColorSample out;
+  ColorSample dark = {0, 0, 300, 300, 300};
+  ColorSample tinted = {5000, 0, 300, 300, 650};
+  TEST_ASSERT_TRUE(compressor.push(dark, out));
+  TEST_ASSERT_TRUE(compressor.push(tinted, out));
+  TEST_ASSERT_EQUAL(650, out.blue);
+}
+
+int main(int, char**)
+{
+  buildSyntheticTrace();
+  recordedCount = loadRecordedTrace(getenv("SENSOR_TRACE") ? getenv("SENSOR_TRACE") : DEFAULT_SENSOR_TRACE);
+  UNITY_BEGIN();
+  RUN_TEST(test_recorded_trace);
+  RUN_TEST(test_shipped_config_on_synthetic_trace);
+  RUN_TEST(test_swinging_door_on_synthetic_trace);
+  RUN_TEST(test_disabled_compression_keeps_everything);
+  RUN_TEST(test_delta_e_only_has_no_per_channel_bound);
+  RUN_TEST(test_delta_e_keeps_a_perceptible_change_inside_the_deadband);
+  return UNITY_END();
+}
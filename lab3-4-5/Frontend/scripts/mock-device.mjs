@@ -0,0 +1,113 @@
+// Локальна імітація ESP8266 для розробки без пристрою.
+//
+//   npm run mock-device -- --rows 10000 --port 8081
+//   VITE_API_BASE_URL=http://localhost:8081 npm run dev
+//
+// Відтворює /api/measurements прошивки: ?since=<id>, слабкий ETag
+// W/"<покоління>-<останній id>", Last-Modified останнього запису, 304 на
+// If-None-Match (або на If-Modified-Since, якщо ETag не надіслано) і CORS.
+// Щохвилини друкує кількість запитів і байтів, щоб порівнювати навантаження
+// фронтенду.
+// З --trace кожен запит друкується рядком @H, як у прошивці з
+// -DTRACE_RECORDING, тож сесію можна повторити через tools/trace-replay.
+import http from 'node:http'
+
+const args = process.argv.slice(2)
+const option = (name, fallback) => {
+  const index = args.indexOf(`--${name}`)
+  return index >= 0 ? Number(args[index + 1]) : fallback
+}
+
+const port = option('port', 8081)
+const seedRows = option('rows', 50)
+const sampleInterval = option('interval', 5000)
+const generation = Date.now() % 100000
+const trace = args.includes('--trace')
+const HTTP_METHODS = ['GET', 'HEAD', 'POST', 'PUT', 'PATCH', 'DELETE', 'OPTIONS']
+
+// Текстові поля @H кодуються так само, як у TraceRecorder: '%', ',' і
+// керівні символи стають %XX.
+const traceField = (text = '') =>
+  text.replace(/[%,\x00-\x1f\x7f]/g, (c) => `%${c.charCodeAt(0).toString(16).toUpperCase().padStart(2, '0')}`)
+
+const measurements = []
+const addMeasurement = (time) => {
+  const id = measurements.length + 1
+  const phase = id / 50
+  measurements.push({
+    id,
+    red: Math.round(128 + 100 * Math.sin(phase)),
+    green: Math.round(128 + 100 * Math.sin(phase + 2)),
+    blue: Math.round(128 + 100 * Math.sin(phase + 4)),
+    createdAt: new Date(time).toISOString()
+  })
+}
+
+const start = Date.now() - seedRows * sampleInterval
+for (let i = 0; i < seedRows; i++) addMeasurement(start + i * sampleInterval)
+setInterval(() => addMeasurement(Date.now()), sampleInterval)
+
+const stats = { requests: 0, notModified: 0, bytes: 0 }
+setInterval(() => {
+  console.log(`[mock] ${stats.requests} req/min, ${stats.notModified} × 304, ${stats.bytes} bytes`)
+  stats.requests = stats.notModified = stats.bytes = 0
+}, 60000)
+
+const corsHeaders = {
+  'Access-Control-Allow-Origin': '*',
+  'Access-Control-Allow-Methods': 'GET, POST, OPTIONS',
+  'Access-Control-Allow-Headers': 'Content-Type, If-None-Match, If-Modified-Since',
+  'Access-Control-Expose-Headers': 'ETag, Last-Modified'
+}
+
+http.createServer((req, res) => {
+  const url = new URL(req.url ?? '/', `http://localhost:${port}`)
+  if (trace) {
+    const received = process.hrtime.bigint()
+    res.on('finish', () => {
+      const method = HTTP_METHODS.indexOf(req.method ?? 'GET') + 1
+      const us = (process.hrtime.bigint() - received) / 1000n
+      const fields = [
+        Date.now(), method, traceField(`${url.pathname}${url.search}`), us,
+        traceField(req.headers['if-none-match']), traceField(req.headers['if-modified-since'])
+      ]
+      console.log(`@H,${fields.join(',')}`)
+    })
+  }
+
+  if (req.method === 'OPTIONS') {
+    res.writeHead(204, corsHeaders).end()
+    return
+  }
+
+  if (url.pathname !== '/api/measurements') {
+    res.writeHead(404, { ...corsHeaders, 'Content-Type': 'application/json' })
+    res.end('{"error":"Endpoint not found"}')
+    return
+  }
+
+  stats.requests++
+  const lastId = measurements.length
+  const etag = `W/"${generation}-${lastId}"`
+  const lastModified = lastId > 0 ? new Date(measurements[lastId - 1].createdAt).toUTCString() : null
+  const headers = { ...corsHeaders, 'Cache-Control': 'no-cache', ETag: etag }
+  if (lastModified) headers['Last-Modified'] = lastModified
+
+  const ifNoneMatch = req.headers['if-none-match']
+  const notModified = ifNoneMatch
+    ? ifNoneMatch === etag
+    : lastModified !== null && req.headers['if-modified-since'] === lastModified
+  if (notModified) {
+    stats.notModified++
+    res.writeHead(304, headers).end()
+    return
+  }
+
+  const since = Number(url.searchParams.get('since') ?? 0)
+  const body = JSON.stringify(measurements.filter((item) => item.id > since))
+  stats.bytes += Buffer.byteLength(body)
+  res.writeHead(200, { ...headers, 'Content-Type': 'application/json' })
+  res.end(body)
+}).listen(port, () => {
+  console.log(`[mock] device on http://localhost:${port} with ${seedRows} rows`)
+})
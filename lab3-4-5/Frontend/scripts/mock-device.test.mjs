@@ -0,0 +1,54 @@
+// Перевіряє, що mock-device відповідає так само, як прошивка:
+//
+//   npm run test:mock-device
+import { spawn } from 'node:child_process'
+import { once } from 'node:events'
+import { after, before, test } from 'node:test'
+import assert from 'node:assert/strict'
+
+const port = 18000 + Math.floor(Math.random() * 1000)
+const url = `http://localhost:${port}/api/measurements`
+let device
+
+before(async () => {
+  device = spawn(process.execPath, ['scripts/mock-device.mjs', '--port', port, '--rows', 20, '--interval', 600000])
+  const [line] = await once(device.stdout, 'data')
+  assert.match(line.toString(), /device on/)
+})
+
+after(() => device.kill())
+
+const get = (path = '', headers = {}) => fetch(`${url}${path}`, { headers })
+
+test('повна відповідь має ETag і Last-Modified', async () => {
+  const res = await get()
+  assert.equal(res.status, 200)
+  assert.match(res.headers.get('etag'), /^W\/"\d+-20"$/)
+  const rows = await res.json()
+  assert.equal(rows.length, 20)
+  assert.equal(res.headers.get('last-modified'), new Date(rows[19].createdAt).toUTCString())
+})
+
+test('304 на збіг If-None-Match', async () => {
+  const etag = (await get()).headers.get('etag')
+  const res = await get('', { 'If-None-Match': etag })
+  assert.equal(res.status, 304)
+  assert.equal(res.headers.get('etag'), etag)
+})
+
+test('304 на If-Modified-Since без If-None-Match', async () => {
+  const lastModified = (await get()).headers.get('last-modified')
+  const res = await get('', { 'If-Modified-Since': lastModified })
+  assert.equal(res.status, 304)
+})
+
+test('If-Modified-Since ігнорується, коли є If-None-Match', async () => {
+  const lastModified = (await get()).headers.get('last-modified')
+  const res = await get('', { 'If-None-Match': 'W/"0-0"', 'If-Modified-Since': lastModified })
+  assert.equal(res.status, 200)
+})
+
+test('since повертає лише нові записи', async () => {
+  const rows = await (await get('?since=15')).json()
+  assert.deepEqual(rows.map((row) => row.id), [16, 17, 18, 19, 20])
+})
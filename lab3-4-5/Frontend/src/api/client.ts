@@ -0,0 +1,42 @@
+import axios from 'axios'
+
+export const API_BASE_URL = import.meta.env.VITE_API_BASE_URL ?? 'http://192.168.4.1'
+
+export interface Validators {
+  etag: string | null
+  lastModified: string | null
+}
+
+export interface ConditionalResult<T> extends Validators {
+  data: T | null
+}
+
+const headerValue = (value: unknown): string | null =>
+  typeof value === 'string' && value.length > 0 ? value : null
+
+const api = axios.create({
+  baseURL: API_BASE_URL,
+  validateStatus: (status) => (status >= 200 && status < 300) || status === 304
+})
+
+// GET з умовними заголовками: пристрій відповідає 304 без тіла, якщо з моменту
+// отримання `validators` нових вимірювань не з'явилось. Тоді data === null.
+// If-Modified-Since пристрій перевіряє лише тоді, коли ETag не надіслано
+// (наприклад, проксі його відкинув), тож передаються обидва.
+export async function getConditional<T>(url: string, validators: Validators): Promise<ConditionalResult<T>> {
+  const headers: Record<string, string> = {}
+  if (validators.etag) headers['If-None-Match'] = validators.etag
+  if (validators.lastModified) headers['If-Modified-Since'] = validators.lastModified
+
+  const res = await api.get<T>(url, { headers })
+  if (res.status === 304) {
+    return { data: null, ...validators }
+  }
+  return {
+    data: res.data,
+    etag: headerValue(res.headers['etag']),
+    lastModified: headerValue(res.headers['last-modified'])
+  }
+}
+
+export default api
@@ -1,5 +1,5 @@
-import { useEffect, useState } from 'react'
-import axios from 'axios'
+import { useMemo } from 'react'
+import { useMeasurements } from '../store/measurementStore'
 import { motion, AnimatePresence } from 'framer-motion'
 import tinycolor from 'tinycolor2'
 
@@ -20,60 +20,57 @@ interface ProcessedColor {
   }
 }
 
-export default function ColorBox() {
-  const [processedColor, setProcessedColor] = useState<ProcessedColor>({
-    rgb: 'rgb(0, 0, 0)',
-    hex: '#000000',
-    name: 'Чорний',
-    hsl: { h: 0, s: 0, l: 0 }
-  })
-  const [isLoading, setIsLoading] = useState(true)
-  const [error, setError] = useState<string | null>(null)
-
-  const baseColors = [
-    { name: 'Червоний', hex: '#FF0000' },
-    { name: 'Зелений', hex: '#00FF00' },
-    { name: 'Синій', hex: '#0000FF' },
-    { name: 'Жовтий', hex: '#FFFF00' },
-    { name: 'Пурпурний', hex: '#FF00FF' },
-    { name: 'Бірюзовий', hex: '#00FFFF' },
-    { name: 'Білий', hex: '#FFFFFF' },
-    { name: 'Чорний', hex: '#000000' },
-    { name: 'Сірий', hex: '#808080' },
-    { name: 'Оранжевий', hex: '#FFA500' },
-    { name: 'Рожевий', hex: '#FFC0CB' },
-    { name: 'Коричневий', hex: '#A52A2A' }
-  ]
-
-  const calculateColorDistance = (color1: tinycolor.Instance, color2: tinycolor.Instance): number => {
-    const rgb1 = color1.toRgb()
-    const rgb2 = color2.toRgb()
-    
-    return Math.sqrt(
-      Math.pow(rgb1.r - rgb2.r, 2) +
-      Math.pow(rgb1.g - rgb2.g, 2) +
-      Math.pow(rgb1.b - rgb2.b, 2)
-    )
-  }
+const BLACK: ProcessedColor = {
+  rgb: 'rgb(0, 0, 0)',
+  hex: '#000000',
+  name: 'Чорний',
+  hsl: { h: 0, s: 0, l: 0 }
+}
 
-  const findClosestColor = (color: tinycolor.Instance): string => {
-    let minDistance = Number.MAX_VALUE
-    let closestColor = 'Невідомий'
-
-    baseColors.forEach(baseColor => {
-      const baseColorObj = tinycolor(baseColor.hex)
-      const distance = calculateColorDistance(color, baseColorObj)
-      
-      if (distance < minDistance) {
-        minDistance = distance
-        closestColor = baseColor.name
-      }
-    })
+const baseColors = [
+  { name: 'Червоний', hex: '#FF0000' },
+  { name: 'Зелений', hex: '#00FF00' },
+  { name: 'Синій', hex: '#0000FF' },
+  { name: 'Жовтий', hex: '#FFFF00' },
+  { name: 'Пурпурний', hex: '#FF00FF' },
+  { name: 'Бірюзовий', hex: '#00FFFF' },
+  { name: 'Білий', hex: '#FFFFFF' },
+  { name: 'Чорний', hex: '#000000' },
+  { name: 'Сірий', hex: '#808080' },
+  { name: 'Оранжевий', hex: '#FFA500' },
+  { name: 'Рожевий', hex: '#FFC0CB' },
+  { name: 'Коричневий', hex: '#A52A2A' }
+]
+
+const calculateColorDistance = (color1: tinycolor.Instance, color2: tinycolor.Instance): number => {
+  const rgb1 = color1.toRgb()
+  const rgb2 = color2.toRgb()
+  
+  return Math.sqrt(
+    Math.pow(rgb1.r - rgb2.r, 2) +
+    Math.pow(rgb1.g - rgb2.g, 2) +
+    Math.pow(rgb1.b - rgb2.b, 2)
+  )
+}
 
-    return closestColor
-  }
+const findClosestColor = (color: tinycolor.Instance): string => {
+  let minDistance = Number.MAX_VALUE
+  let closestColor = 'Невідомий'
 
-  const normalizeRGB = (red: number, green: number, blue: number): RawColor => {
+  baseColors.forEach(baseColor => {
+    const baseColorObj = tinycolor(baseColor.hex)
+    const distance = calculateColorDistance(color, baseColorObj)
+    
+    if (distance < minDistance) {
+      minDistance = distance
+      closestColor = baseColor.name
+    }
+  })
+
+  return closestColor
+}
+
+const normalizeRGB = (red: number, green: number, blue: number): RawColor => {
   // Замість жорсткої обрізки до 255, нормалізуй до 0–255 на основі макс. значення сенсора
   const maxSensorValue = 4095 // або 3300, якщо твій сенсор має такий діапазон
 
@@ -91,63 +88,46 @@ export default function ColorBox() {
   }
 }
 
-  const processColor = (raw: RawColor): ProcessedColor => {
-    try {
-      const normalized = normalizeRGB(raw.red, raw.green, raw.blue)
-      const color = tinycolor({ r: normalized.red, g: normalized.green, b: normalized.blue })
-      const hsl = color.toHsl()
-      
-      const processed = {
-        rgb: color.toRgbString(),
-        hex: color.toHexString(),
-        name: findClosestColor(color),
-        hsl: {
-          h: Math.round(hsl.h),
-          s: Math.round(hsl.s),
-          l: Math.round(hsl.l)
-        }
+const processColor = (raw: RawColor): ProcessedColor => {
+  try {
+    const normalized = normalizeRGB(raw.red, raw.green, raw.blue)
+    const color = tinycolor({ r: normalized.red, g: normalized.green, b: normalized.blue })
+    const hsl = color.toHsl()
+    
+    const processed = {
+      rgb: color.toRgbString(),
+      hex: color.toHexString(),
+      name: findClosestColor(color),
+      hsl: {
+        h: Math.round(hsl.h),
+        s: Math.round(hsl.s),
+        l: Math.round(hsl.l)
       }
+    }
 
-      console.log('Processed color:', processed)
-      return processed
-    } catch (error) {
-      console.error('Error processing color:', error)
-      return {
-        rgb: 'rgb(0, 0, 0)',
-        hex: '#000000',
-        name: 'Помилка',
-        hsl: { h: 0, s: 0, l: 0 }
-      }
+    console.log('Processed color:', processed)
+    return processed
+  } catch (error) {
+    console.error('Error processing color:', error)
+    return {
+      rgb: 'rgb(0, 0, 0)',
+      hex: '#000000',
+      name: 'Помилка',
+      hsl: { h: 0, s: 0, l: 0 }
     }
   }
+}
 
-  useEffect(() => {
-    const fetchColor = async () => {
-      try {
-        setIsLoading(true)
-        setError(null)
-        const res = await axios.get('http://192.168.4.1/api/measurements')
-        const latestMeasurement = res.data[0]
-        
-        if (latestMeasurement) {
-          console.log('Latest measurement from API:', latestMeasurement)
-          const processed = processColor(latestMeasurement)
-          setProcessedColor(processed)
-        } else {
-          setError('Немає доступних вимірювань')
-        }
-      } catch (err) {
-        setError('Помилка отримання даних')
-        console.error('Error fetching color:', err)
-      } finally {
-        setIsLoading(false)
-      }
-    }
+export default function ColorBox() {
+  const { measurements, isLoading, error: fetchError } = useMeasurements()
+  const latestMeasurement = measurements[measurements.length - 1]
 
-    fetchColor()
-    const interval = setInterval(fetchColor, 3000)
-    return () => clearInterval(interval)
-  }, [])
+  // Колір перераховується лише тоді, коли з'являється новий запис.
+  const processedColor = useMemo<ProcessedColor>(
+    () => latestMeasurement ? processColor(latestMeasurement) : BLACK,
+    [latestMeasurement]
+  )
+  const error = fetchError ?? (!isLoading && !latestMeasurement ? 'Немає доступних вимірювань' : null)
 
   const textColor = processedColor.hsl.l > 50 ? 'text-gray-900' : 'text-white'
 
@@ -1,72 +1,35 @@
-import { useEffect, useState } from 'react'
-import axios from 'axios'
+import { useState } from 'react'
 import CustomButton from './CustomButton'
 import { useNavigate } from 'react-router-dom'
 import { motion, AnimatePresence } from 'framer-motion'
-import tinycolor from 'tinycolor2'
+import { useMeasurements } from '../store/measurementStore'
+import { getColorInfo, formatDate } from '../utils/color'
 
-interface Measurement {
-  id: number
-  red: number
-  green: number
-  blue: number
-  createdAt: string
-}
+const ROW_HEIGHT = 64
+const VIEWPORT_HEIGHT = 480
+const OVERSCAN = 5
 
 export default function HistoryTable() {
-  const [history, setHistory] = useState<Measurement[]>([])
-  const [isLoading, setIsLoading] = useState(true)
-  const [error, setError] = useState<string | null>(null)
+  const { measurements: history, isLoading, error } = useMeasurements()
+  const [scrollTop, setScrollTop] = useState(0)
   const navigate = useNavigate()
 
-  useEffect(() => {
-    const fetchHistory = async () => {
-      try {
-        setIsLoading(true)
-        setError(null)
-        const res = await axios.get<Measurement[]>('http://192.168.4.1/api/measurements')
-        setHistory(res.data)
-      } catch (err) {
-        setError('Помилка отримання даних')
-        console.error('Error fetching history:', err)
-      } finally {
-        setIsLoading(false)
-      }
-    }
-
-    fetchHistory()
-    const interval = setInterval(fetchHistory, 5000)
-    return () => clearInterval(interval)
-  }, [])
-
   const handleView = (id: string) => {
     navigate(`/measurements/${id}`)
   }
 
-  const formatDate = (dateString: string) => {
-    const date = new Date(dateString)
-    return date.toLocaleString('uk-UA', {
-      year: 'numeric',
-      month: '2-digit',
-      day: '2-digit',
-      hour: '2-digit',
-      minute: '2-digit',
-      second: '2-digit'
-    })
-  }
-
-  const getColorInfo = (red: number, green: number, blue: number) => {
-    const color = tinycolor({ r: red, g: green, b: blue })
-    const hsl = color.toHsl()
-    return {
-      rgb: color.toRgbString(),
-      hex: color.toHexString(),
-      brightness: hsl.l
-    }
-  }
+  // Рендеряться лише рядки у видимій області (плюс запас), решта замінюється
+  // порожніми рядками-розпірками потрібної висоти.
+  const firstRow = Math.max(0, Math.floor(scrollTop / ROW_HEIGHT) - OVERSCAN)
+  const lastRow = Math.min(history.length, Math.ceil((scrollTop + VIEWPORT_HEIGHT) / ROW_HEIGHT) + OVERSCAN)
+  const visibleRows = history.slice(firstRow, lastRow)
 
   return (
-    <div className="overflow-x-auto">
+    <div
+      className="overflow-auto"
+      style={{ maxHeight: VIEWPORT_HEIGHT }}
+      onScroll={(event) => setScrollTop(event.currentTarget.scrollTop)}
+    >
       <AnimatePresence mode="wait">
         {isLoading ? (
           <motion.div
@@ -96,7 +59,7 @@ export default function HistoryTable() {
             exit={{ opacity: 0, y: -20 }}
             className="min-w-full divide-y divide-gray-200 dark:divide-gray-700"
           >
-            <thead className="bg-gray-50 dark:bg-gray-800">
+            <thead className="bg-gray-50 dark:bg-gray-800 sticky top-0 z-10">
               <tr>
                 <th scope="col" className="px-6 py-3 text-left text-xs font-medium text-gray-500 dark:text-gray-400 uppercase tracking-wider">
                   Дата
@@ -113,22 +76,23 @@ export default function HistoryTable() {
               </tr>
             </thead>
             <tbody className="bg-white dark:bg-gray-900 divide-y divide-gray-200 dark:divide-gray-700">
-              {history.map((item, index) => {
+              {firstRow > 0 && (
+                <tr style={{ height: firstRow * ROW_HEIGHT }} aria-hidden="true" />
+              )}
+              {visibleRows.map((item) => {
                 const colorInfo = getColorInfo(item.red, item.green, item.blue)
                 const textColor = colorInfo.brightness > 50 ? 'text-gray-900' : 'text-white'
-                
+
                 return (
-                  <motion.tr
+                  <tr
                     key={item.id}
-                    initial={{ opacity: 0, y: 20 }}
-                    animate={{ opacity: 1, y: 0 }}
-                    transition={{ delay: index * 0.05 }}
+                    style={{ height: ROW_HEIGHT }}
                     className="hover:bg-gray-50 dark:hover:bg-gray-800"
                   >
-                    <td className="px-6 py-4 whitespace-nowrap text-sm text-gray-900 dark:text-gray-100">
+                    <td className="px-6 whitespace-nowrap text-sm text-gray-900 dark:text-gray-100">
                       {formatDate(item.createdAt)}
                     </td>
-                    <td className="px-6 py-4 whitespace-nowrap">
+                    <td className="px-6 whitespace-nowrap">
                       <div className="flex items-center gap-4">
                         <div 
                           className="w-8 h-8 rounded-lg shadow-md"
@@ -139,10 +103,10 @@ export default function HistoryTable() {
                         </span>
                       </div>
                     </td>
-                    <td className="px-6 py-4 whitespace-nowrap text-sm text-gray-900 dark:text-gray-100">
+                    <td className="px-6 whitespace-nowrap text-sm text-gray-900 dark:text-gray-100">
                       {colorInfo.rgb}
                     </td>
-                    <td className="px-6 py-4 whitespace-nowrap text-right text-sm font-medium">
+                    <td className="px-6 whitespace-nowrap text-right text-sm font-medium">
                       <CustomButton
                         handleClick={() => handleView(item.id.toString())}
                         styles="bg-blue-500 text-white px-3 py-1 rounded hover:bg-blue-600 transition-colors"
@@ -151,9 +115,12 @@ export default function HistoryTable() {
                         Деталі
                       </CustomButton>
                     </td>
-                  </motion.tr>
+                  </tr>
                 )
               })}
+              {lastRow < history.length && (
+                <tr style={{ height: (history.length - lastRow) * ROW_HEIGHT }} aria-hidden="true" />
+              )}
             </tbody>
           </motion.table>
         )}
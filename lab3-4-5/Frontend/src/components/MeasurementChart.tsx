@@ -1,40 +1,25 @@
 import { LineChart, Line, XAxis, YAxis, Tooltip, Legend, ResponsiveContainer } from 'recharts'
 import type { TooltipProps } from 'recharts'
-import { useEffect, useState } from 'react'
-import axios from 'axios'
+import { useMemo } from 'react'
 import { motion, AnimatePresence } from 'framer-motion'
+import { useMeasurements, type Measurement } from '../store/measurementStore'
 
-interface Measurement {
-  createdAt: string
-  red: number
-  green: number
-  blue: number
+// Графік охоплює всю історію, але не більше CHART_POINTS точок: довга серія
+// проріджується рівномірним кроком, остання точка лишається завжди.
+const CHART_POINTS = 500
+
+function downsample(measurements: Measurement[]): Measurement[] {
+  if (measurements.length <= CHART_POINTS) return measurements
+  const step = measurements.length / CHART_POINTS
+  const points: Measurement[] = []
+  for (let i = 0; i < CHART_POINTS - 1; i++) points.push(measurements[Math.floor(i * step)])
+  points.push(measurements[measurements.length - 1])
+  return points
 }
 
 export default function MeasurementChart() {
-  const [data, setData] = useState<Measurement[]>([])
-  const [isLoading, setIsLoading] = useState(true)
-  const [error, setError] = useState<string | null>(null)
-
-  useEffect(() => {
-    const fetchData = async () => {
-      try {
-        setIsLoading(true)
-        setError(null)
-        const res = await axios.get<Measurement[]>('http://192.168.4.1/api/measurements')
-        setData(res.data)
-      } catch (err) {
-        setError('Помилка отримання даних')
-        console.error('Error fetching measurements:', err)
-      } finally {
-        setIsLoading(false)
-      }
-    }
-
-    fetchData()
-    const interval = setInterval(fetchData, 5000)
-    return () => clearInterval(interval)
-  }, [])
+  const { measurements, isLoading, error } = useMeasurements()
+  const data = useMemo(() => downsample(measurements), [measurements])
 
   const CustomTooltip = ({ active, payload, label }: TooltipProps<number, string>) => {
     if (active && payload && payload.length) {
@@ -109,6 +94,7 @@ export default function MeasurementChart() {
                   strokeWidth={2}
                   dot={false}
                   activeDot={{ r: 6 }}
+                  isAnimationActive={false}
                 />
                 <Line 
                   type="monotone" 
@@ -118,6 +104,7 @@ export default function MeasurementChart() {
                   strokeWidth={2}
                   dot={false}
                   activeDot={{ r: 6 }}
+                  isAnimationActive={false}
                 />
                 <Line 
                   type="monotone" 
@@ -127,6 +114,7 @@ export default function MeasurementChart() {
                   strokeWidth={2}
                   dot={false}
                   activeDot={{ r: 6 }}
+                  isAnimationActive={false}
                 />
               </LineChart>
             </ResponsiveContainer>
@@ -1,64 +1,15 @@
-import { useEffect, useState } from 'react'
 import { useParams, useNavigate } from 'react-router-dom'
-import axios from 'axios'
 import { motion, AnimatePresence } from 'framer-motion'
-import tinycolor from 'tinycolor2'
 import CustomButton from '../components/CustomButton'
-
-interface MeasurementData {
-  id: number
-  red: number
-  green: number
-  blue: number
-  createdAt: string
-}
+import { useMeasurements } from '../store/measurementStore'
+import { getColorInfo, formatDate } from '../utils/color'
 
 export default function MeasurementDetail() {
   const { id } = useParams<{ id: string }>()
   const navigate = useNavigate()
-  const [measurement, setMeasurement] = useState<MeasurementData | null>(null)
-  const [isLoading, setIsLoading] = useState(true)
-  const [error, setError] = useState<string | null>(null)
-
-  useEffect(() => {
-    const fetchMeasurement = async () => {
-      try {
-        setIsLoading(true)
-        setError(null)
-        const res = await axios.get<MeasurementData>(`http://192.168.4.1/api/measurements/${id}`)
-        setMeasurement(res.data)
-      } catch (err) {
-        setError('Помилка отримання даних')
-        console.error('Error fetching measurement:', err)
-      } finally {
-        setIsLoading(false)
-      }
-    }
-
-    fetchMeasurement()
-  }, [id])
-
-  const formatDate = (dateString: string) => {
-    const date = new Date(dateString)
-    return date.toLocaleString('uk-UA', {
-      year: 'numeric',
-      month: '2-digit',
-      day: '2-digit',
-      hour: '2-digit',
-      minute: '2-digit',
-      second: '2-digit'
-    })
-  }
-
-  const getColorInfo = (red: number, green: number, blue: number) => {
-    const color = tinycolor({ r: red, g: green, b: blue })
-    const hsl = color.toHsl()
-    return {
-      rgb: color.toRgbString(),
-      hex: color.toHexString(),
-      brightness: hsl.l
-    }
-  }
+  const { measurements, isLoading, error: fetchError } = useMeasurements()
+  const measurement = measurements.find((item) => item.id.toString() === id) ?? null
+  const error = fetchError ?? (!isLoading && !measurement ? 'Вимірювання не знайдено' : null)
 
   return (
     <div className="max-w-4xl mx-auto px-4 sm:px-6 lg:px-8 py-8">
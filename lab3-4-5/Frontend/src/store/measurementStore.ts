@@ -0,0 +1,95 @@
+import { useSyncExternalStore } from 'react'
+import { getConditional, type Validators } from '../api/client'
+
+export interface Measurement {
+  id: number
+  red: number
+  green: number
+  blue: number
+  createdAt: string
+}
+
+export interface MeasurementState {
+  measurements: Measurement[]
+  isLoading: boolean
+  error: string | null
+}
+
+const POLL_INTERVAL = 3000
+
+// Одне спільне джерело даних для всіх компонентів: поки є хоч один підписник,
+// пристрій опитується одним таймером, а нові записи дописуються в кінець масиву.
+let state: MeasurementState = { measurements: [], isLoading: true, error: null }
+let validators: Validators = { etag: null, lastModified: null }
+let timer: ReturnType<typeof setInterval> | null = null
+let inFlight = false
+const listeners = new Set<() => void>()
+
+// ETag має вигляд W/"<покоління>-<останній id>"; покоління змінюється після
+// перезавантаження пристрою, і тоді id починаються спочатку.
+const generationOf = (tag: string | null) => tag?.match(/"(\d+)-/)?.[1] ?? null
+
+function setState(patch: Partial<MeasurementState>) {
+  state = { ...state, ...patch }
+  listeners.forEach((listener) => listener())
+}
+
+async function poll(): Promise<void> {
+  if (inFlight) return
+  inFlight = true
+  let restarted = false
+
+  try {
+    const { measurements } = state
+    const lastId = measurements.length > 0 ? measurements[measurements.length - 1].id : 0
+    const res = await getConditional<Measurement[]>(`/api/measurements?since=${lastId}`, validators)
+
+    if (res.data === null) {
+      if (state.isLoading || state.error) setState({ isLoading: false, error: null })
+      return
+    }
+
+    if (validators.etag !== null && generationOf(res.etag) !== generationOf(validators.etag)) {
+      restarted = true
+      validators = { etag: null, lastModified: null }
+      setState({ measurements: [] })
+      return
+    }
+
+    validators = { etag: res.etag, lastModified: res.lastModified }
+    const fresh = res.data.filter((item) => item.id > lastId)
+    setState({
+      measurements: fresh.length > 0 ? measurements.concat(fresh) : measurements,
+      isLoading: false,
+      error: null
+    })
+  } catch (err) {
+    console.error('Error fetching measurements:', err)
+    setState({ isLoading: false, error: 'Помилка отримання даних' })
+  } finally {
+    inFlight = false
+    if (restarted) void poll()
+  }
+}
+
+function subscribe(listener: () => void) {
+  listeners.add(listener)
+  if (timer === null) {
+    void poll()
+    timer = setInterval(poll, POLL_INTERVAL)
+  }
+
+  return () => {
+    listeners.delete(listener)
+    if (listeners.size === 0 && timer !== null) {
+      clearInterval(timer)
+      timer = null
+    }
+  }
+}
+
+const getSnapshot = () => state
+
+export function useMeasurements(): MeasurementState {
+  return useSyncExternalStore(subscribe, getSnapshot)
+}
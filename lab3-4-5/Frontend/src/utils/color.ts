@@ -0,0 +1,39 @@
+import tinycolor from 'tinycolor2'
+
+export interface ColorInfo {
+  rgb: string
+  hex: string
+  brightness: number
+}
+
+// Перетворення кешуються за значенням RGB: історія містить багато однакових
+// кольорів, а tinycolor для кожного рядка при кожному рендері — це дорого.
+const colorCache = new Map<string, ColorInfo>()
+
+export function getColorInfo(red: number, green: number, blue: number): ColorInfo {
+  const key = `${red},${green},${blue}`
+  let info = colorCache.get(key)
+  if (!info) {
+    const color = tinycolor({ r: red, g: green, b: blue })
+    info = {
+      rgb: color.toRgbString(),
+      hex: color.toHexString(),
+      brightness: color.toHsl().l
+    }
+    colorCache.set(key, info)
+  }
+  return info
+}
+
+const dateFormat = new Intl.DateTimeFormat('uk-UA', {
+  year: 'numeric',
+  month: '2-digit',
+  day: '2-digit',
+  hour: '2-digit',
+  minute: '2-digit',
+  second: '2-digit'
+})
+
+export function formatDate(dateString: string): string {
+  return dateFormat.format(new Date(dateString))
+}
@@ -0,0 +1,237 @@
+#!/usr/bin/env node
+// Record-and-replay harness for the ESP8266 firmwares.
+//
+// A trace is the serial log of a firmware built with -DTRACE_RECORDING
+// (envs *_trace in lab2/2 device and lab3-4-5/Esp), or the stdout of
+// `npm run mock-device -- --trace` in lab3-4-5/Frontend. Only lines carrying
+// '@' records are used; see common/TraceRecorder/TraceRecorder.h.
+//
+//   node trace-replay.mjs summarize <trace>
+//   node trace-replay.mjs replay <trace> --target http://192.168.4.1 [--speed 1|4|max]
+//   node trace-replay.mjs compare <baseline.json> <candidate.json>
+//
+// Every command prints JSON on stdout. `replay` re-issues the recorded HTTP
+// requests in order against the target, with the recorded method, path,
+// query (e.g. ?since=) and If-None-Match / If-Modified-Since headers, either
+// on the recorded schedule (scaled by --speed) or back to back with
+// --speed max. Capture the device's serial output during a replay and
+// `summarize` it to get the device-side loop latency and heap figures for
+// the same traffic.
+//
+// Only the HTTP side is replayed. Sensor readings, button interrupts and
+// serial bytes are counted by `summarize` but not injected, so the device
+// samples its real inputs during a replay. Whether a recorded validator
+// still matches depends on the target's state: the ETag carries the storage
+// generation, which changes on every boot, so replaying against a freshly
+// booted device gets 200s where the recording got 304s.
+//
+// For a deterministic replay of the sensor readings as well, lab3-4-5/Esp
+// has a host build that feeds a recording through the firmware modules:
+// `pio run -e native_replay`, then `.pio/build/native_replay/program <trace>`
+// (see lab3-4-5/Esp/replay/TraceReplay.cpp). lab2/2 traces have no such
+// replay.
+import { readFileSync } from 'node:fs'
+
+const HTTP_METHODS = ['GET', 'GET', 'HEAD', 'POST', 'PUT', 'PATCH', 'DELETE', 'OPTIONS']
+const EVENT_KINDS = { S: 'sensor', B: 'button', R: 'serialRx', T: 'serialTx', W: 'websocket' }
+const LOOP_BUCKETS = 16
+const REQUEST_TIMEOUT = 5000
+
+// Undoes the %XX encoding TraceRecorder applies to @H text fields.
+const decodeField = (text) =>
+  text.replace(/%([0-9A-Fa-f]{2})/g, (_, hex) => String.fromCharCode(parseInt(hex, 16)))
+
+function parseTrace(path) {
+  const trace = { events: [], requests: [], loops: new Array(LOOP_BUCKETS).fill(0), memory: [] }
+
+  for (const raw of readFileSync(path, 'utf8').split('\n')) {
+    const start = raw.indexOf('@')
+    if (start < 0) continue
+    const fields = raw.slice(start + 1).trim().split(',')
+    const at = Number(fields[1])
+
+    switch (fields[0]) {
+      case 'E':
+        trace.events.push({ at, kind: fields[2], a: Number(fields[3]), b: Number(fields[4]) })
+        break
+      case 'H':
+        // @H,<ms>,<method>,<uri>,<us>,<ifNoneMatch>,<ifModifiedSince>. Older
+        // traces end at <us> and leave commas in <uri> unencoded.
+        if (fields.length === 7) {
+          trace.requests.push({
+            at,
+            method: HTTP_METHODS[Number(fields[2])] ?? 'GET',
+            uri: decodeField(fields[3]),
+            durationUs: Number(fields[4]),
+            ifNoneMatch: decodeField(fields[5]),
+            ifModifiedSince: decodeField(fields[6])
+          })
+        } else {
+          trace.requests.push({
+            at,
+            method: HTTP_METHODS[Number(fields[2])] ?? 'GET',
+            uri: fields.slice(3, -1).join(','),
+            durationUs: Number(fields[fields.length - 1]),
+            ifNoneMatch: '',
+            ifModifiedSince: ''
+          })
+        }
+        break
+      case 'L':
+        fields.slice(3, 3 + LOOP_BUCKETS).forEach((count, i) => { trace.loops[i] += Number(count) })
+        break
+      case 'M':
+        trace.memory.push({
+          at,
+          freeHeap: Number(fields[2]),
+          minFreeHeap: Number(fields[3]),
+          maxFreeBlock: Number(fields[4]),
+          dropped: Number(fields[5])
+        })
+        break
+    }
+  }
+  return trace
+}
+
+function percentiles(values) {
+  if (values.length === 0) return null
+  const sorted = [...values].sort((a, b) => a - b)
+  const pick = (p) => sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))]
+  return { p50: pick(0.5), p90: pick(0.9), p99: pick(0.99), max: sorted[sorted.length - 1] }
+}
+
+// Loop durations arrive as a log2 histogram; each percentile is reported as
+// the upper bound of the bucket it falls in.
+function histogramPercentiles(buckets) {
+  const total = buckets.reduce((sum, count) => sum + count, 0)
+  if (total === 0) return null
+  const pick = (p) => {
+    let seen = 0
+    for (let i = 0; i < buckets.length; i++) {
+      seen += buckets[i]
+      if (seen >= p * total) return 2 ** (i + 1)
+    }
+    return 2 ** buckets.length
+  }
+  const last = buckets.findLastIndex((count) => count > 0)
+  return { loops: total, p50: pick(0.5), p90: pick(0.9), p99: pick(0.99), max: 2 ** (last + 1) }
+}
+
+function summarize(trace) {
+  const times = [...trace.events, ...trace.requests, ...trace.memory].map((item) => item.at)
+  const events = {}
+  for (const event of trace.events) {
+    const name = EVENT_KINDS[event.kind] ?? event.kind
+    events[name] = (events[name] ?? 0) + 1
+  }
+
+  const memory = trace.memory
+  const heap = memory.length === 0 ? null : {
+    initialFree: memory[0].freeHeap,
+    minFree: Math.min(...memory.map((m) => m.minFreeHeap)),
+    highWaterBytes: memory[0].freeHeap - Math.min(...memory.map((m) => m.minFreeHeap)),
+    minMaxFreeBlock: Math.min(...memory.map((m) => m.maxFreeBlock))
+  }
+
+  return {
+    durationMs: times.length > 0 ? Math.max(...times) - Math.min(...times) : 0,
+    events,
+    requests: trace.requests.length,
+    handlerUs: percentiles(trace.requests.map((r) => r.durationUs)),
+    loopLatencyUs: histogramPercentiles(trace.loops),
+    heap,
+    droppedEvents: memory.length > 0 ? memory[memory.length - 1].dropped : 0
+  }
+}
+
+async function replay(trace, target, speed) {
+  const requests = trace.requests
+  const origin = requests.length > 0 ? requests[0].at : 0
+  const startedAt = performance.now()
+  const latencies = []
+  const statuses = {}
+  let failed = 0
+  let bytes = 0
+
+  for (const request of requests) {
+    if (speed !== 'max') {
+      const due = (request.at - origin) / speed
+      const wait = due - (performance.now() - startedAt)
+      if (wait > 0) await new Promise((resolve) => setTimeout(resolve, wait))
+    }
+
+    const headers = {}
+    if (request.ifNoneMatch) headers['If-None-Match'] = request.ifNoneMatch
+    if (request.ifModifiedSince) headers['If-Modified-Since'] = request.ifModifiedSince
+
+    const sent = performance.now()
+    try {
+      const res = await fetch(new URL(request.uri, target), {
+        method: request.method,
+        headers,
+        signal: AbortSignal.timeout(REQUEST_TIMEOUT)
+      })
+      bytes += (await res.arrayBuffer()).byteLength
+      latencies.push(performance.now() - sent)
+      statuses[res.status] = (statuses[res.status] ?? 0) + 1
+    } catch {
+      failed++
+    }
+  }
+
+  const round = (value) => Math.round(value * 100) / 100
+  const latency = percentiles(latencies)
+  return {
+    target,
+    speed,
+    requests: requests.length,
+    failed,
+    statuses,
+    bytes,
+    wallMs: round(performance.now() - startedAt),
+    latencyMs: latency && Object.fromEntries(Object.entries(latency).map(([k, v]) => [k, round(v)]))
+  }
+}
+
+// Relative change of every numeric leaf present in both reports.
+function compare(baseline, candidate, prefix = '', out = {}) {
+  for (const [key, value] of Object.entries(baseline ?? {})) {
+    const other = candidate?.[key]
+    const path = prefix ? `${prefix}.${key}` : key
+    if (typeof value === 'number' && typeof other === 'number') {
+      out[path] = { baseline: value, candidate: other, change: value === 0 ? null : (other - value) / value }
+    } else if (value && typeof value === 'object') {
+      compare(value, other, path, out)
+    }
+  }
+  return out
+}
+
+function option(args, name, fallback) {
+  const index = args.indexOf(`--${name}`)
+  return index >= 0 ? args[index + 1] : fallback
+}
+
+const [command, ...args] = process.argv.slice(2)
+let report
+
+if (command === 'summarize' && args[0]) {
+  report = summarize(parseTrace(args[0]))
+} else if (command === 'replay' && args[0]) {
+  const trace = parseTrace(args[0])
+  const speedOption = option(args, 'speed', '1')
+  const speed = speedOption === 'max' ? 'max' : Number(speedOption)
+  report = {
+    recorded: summarize(trace),
+    replay: await replay(trace, option(args, 'target', 'http://192.168.4.1'), speed)
+  }
+} else if (command === 'compare' && args[1]) {
+  const read = (path) => JSON.parse(readFileSync(path, 'utf8'))
+  report = compare(read(args[0]), read(args[1]))
+} else {
+  console.error('usage: trace-replay.mjs summarize <trace> | replay <trace> --target <url> [--speed 1|max] | compare <a.json> <b.json>')
+  process.exit(2)
+}
+
+console.log(JSON.stringify(report, null, 2))